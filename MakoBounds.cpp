@@ -0,0 +1,46 @@
+/*
+  ==============================================================================
+
+    MakoBounds.cpp
+    Buffer range checks for stress testing.
+
+  ==============================================================================
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include "MakoBounds.h"
+
+#if MAKO_BOUNDS_CHECK
+
+//R1.01 Only the first few are kept. The count keeps going.
+static const int BOUNDS_Keep = 32;
+static MakoBounds::t_Violation Bounds_List[BOUNDS_Keep];
+static std::atomic<int> Bounds_Cnt { 0 };
+
+void MakoBounds::Violation(const char* What, long long Start, long long Count, long long Size) noexcept
+{
+    int n = Bounds_Cnt.fetch_add(1);
+    if (n < BOUNDS_Keep) Bounds_List[n] = { What, Start, Count, Size };
+    assert(!"MakoBounds: out of range buffer access");
+}
+
+int MakoBounds::Count() noexcept
+{
+    return Bounds_Cnt.load();
+}
+
+int MakoBounds::Get(t_Violation* Dest, int Max) noexcept
+{
+    int n = std::min({ Max, BOUNDS_Keep, Bounds_Cnt.load() });
+    for (int t = 0; t < n; t++) Dest[t] = Bounds_List[t];
+    return n;
+}
+
+void MakoBounds::Clear() noexcept
+{
+    Bounds_Cnt = 0;
+}
+
+#endif
@@ -0,0 +1,51 @@
+/*
+  ==============================================================================
+
+    MakoBounds.h
+    Buffer range checks for stress testing.
+    No JUCE, so MakoDSP and MakoEngine can use them too.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+//R1.01 BOUNDS CHECK.
+//R1.01 Build with MAKO_BOUNDS_CHECK=1 to check every segment, delay, bypass and resampler buffer access
+//R1.01 against the size of the buffer before it is made. A bad access is recorded (never allocates, safe
+//R1.01 on the audio thread) and stops a debug build at an assert. Tools/MakoStress.cpp reports them
+//R1.01 when built with NDEBUG.
+//R1.01 When off, everything here compiles to nothing.
+#ifndef MAKO_BOUNDS_CHECK
+ #define MAKO_BOUNDS_CHECK 0
+#endif
+
+#if MAKO_BOUNDS_CHECK
+
+namespace MakoBounds
+{
+    struct t_Violation {
+        const char* What;
+        long long Start;
+        long long Count;
+        long long Size;
+    };
+
+    //R1.01 Record an access of Count items from Start that does not fit in Size.
+    void Violation(const char* What, long long Start, long long Count, long long Size) noexcept;
+
+    //R1.01 Violations since the last Clear. Get copies the first ones (up to Max) into Dest.
+    int Count() noexcept;
+    int Get(t_Violation* Dest, int Max) noexcept;
+    void Clear() noexcept;
+}
+
+ #define MAKO_BOUNDS(start, count, size, what) \
+    do { long long makoS = (long long) (start), makoC = (long long) (count), makoN = (long long) (size); \
+         if ((makoS < 0) || (makoC < 0) || (makoN < makoS + makoC)) MakoBounds::Violation(what, makoS, makoC, makoN); } while (false)
+
+#else
+
+ #define MAKO_BOUNDS(start, count, size, what)
+
+#endif
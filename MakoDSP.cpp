@@ -0,0 +1,194 @@
+/*
+  ==============================================================================
+
+    MakoDSP.cpp
+    Per channel DSP kernels shared by the plugin and the batch engine.
+    No JUCE, so MakoEngine and the Python module can use them too.
+
+  ==============================================================================
+*/
+
+#include "MakoDSP.h"
+#include "MakoBounds.h"
+
+namespace MakoDSP
+{
+
+//R1.00 Second order LOW PASS filter.  fc=Cutoff Frequency.
+void Coeffs_LP(float fc, float Rate, float* c)
+{
+    float k = 1.0f / (tanf(pi * fc / Rate));
+    c[0] = 1.0f / (1.0f + sqrt2 * k + (k * k));
+    c[1] = 2.0f * c[0];
+    c[2] = c[0];
+    c[3] = 2.0f * c[0] * (1.0f - (k * k));
+    c[4] = c[0] * (1.0f - sqrt2 * k + (k * k));
+}
+
+//F1.00 Second order butterworth High Pass. fc=Cutoff Frequency.
+void Coeffs_HP(float fc, float Rate, float* c)
+{
+    float k = tanf(pi * fc / Rate);
+    c[0] = 1.0f / (1.0f + sqrt2 * k + (k * k));
+    c[1] = -2.0f * c[0];
+    c[2] = c[0];
+    c[3] = 2.0f * c[0] * ((k * k) - 1.0f);
+    c[4] = c[0] * (1.0f - sqrt2 * k + (k * k));
+}
+
+//R1.00 Second order parametric/peaking boost filter with constant-Q. fc=Cutoff Frequency. Q=Filter width (.707 def).
+void Coeffs_BP(float Gain_dB, float Fc, float Q, float Rate, float* c)
+{
+    float K = pi2 * (Fc * .5f) / Rate;
+    float K2 = K * K;
+    float V0 = powf(10.0f, Gain_dB / 20.0f);
+
+    float a = 1.0f + (V0 * K) / Q + K2;
+    float b = 2.0f * (K2 - 1.0f);
+    float g = 1.0f - (V0 * K) / Q + K2;
+    float d = 1.0f - K / Q + K2;
+    float dd = 1.0f / (1.0f + K / Q + K2);
+
+    c[0] = a * dd;
+    c[1] = b * dd;
+    c[2] = g * dd;
+    c[3] = b * dd;
+    c[4] = d * dd;
+}
+
+void Sin_Fill(float* Table)
+{
+    //R1.01 The guard point lets the interpolation read one past the last entry.
+    for (int t = 0; t <= SIN_Size; t++) Table[t] = sinf(6.2831853f * float(t) / float(SIN_Size));
+}
+
+float Env_Coef(float ms, float Rate)
+{
+    return expf(-1000.0f / (ms * Rate));
+}
+
+void Env_Powers(float Coef, float* Pow, int n)
+{
+    Pow[0] = 1.0f;
+    for (int t = 1; t <= n; t++) Pow[t] = Pow[t - 1] * Coef;
+}
+
+void Attack_Envelope(const float* Src, int Stride, int num, float AvgPow, float FadePow, float Inc,
+                     float& AVG, float& VolFade, char& VolFadeOn, float& Start, float& Step)
+{
+    //R1.01 Get the average and peak of this segment first.
+    float SumAbs = 0.0f;
+    float MaxSample = 0.0f;
+    for (int t = 0; t < num; t++)
+    {
+        float x = Src[t * Stride];
+        SumAbs += fabsf(x);
+        if (MaxSample < x) MaxSample = x;
+    }
+
+    //R1.00 Calculate our average incoming signal. Blend it for some fixed amount of time.
+    //R1.01 Coef^N gives the same result as N per sample updates with a steady input.
+    AVG = (AVG * AvgPow) + ((SumAbs / num) * (1.0f - AvgPow));
+
+    //R1.00 Detect when a note is played. And retrigger the Attack fade in.
+    //R1.00 This code lets players play non-attacked notes if no silence is between notes.
+    if (!VolFadeOn && (.001f < MaxSample))
+    {
+        VolFadeOn = 1;
+        VolFade = 0.0f;
+    }
+
+    //R1.00 Check for Note off period.
+    if (AVG < .0001f) VolFadeOn = 0;
+
+    //R1.00 Ramp up or down the effect volume based on if playing or not.
+    //R1.01 Find the volume at the end of this segment.
+    float VolEnd;
+    if (.0005f < AVG)
+        VolEnd = VolFade + (Inc * num);     //R1.00 Fade in.
+    else
+        VolEnd = VolFade * FadePow;         //R1.00 Fade out.
+
+    //R1.00 Clip the volume near unity.
+    if (.9999f < VolEnd) VolEnd = .9999f;
+
+    Start = VolFade;
+    Step = (VolEnd - VolFade) / num;
+    VolFade = VolEnd;
+}
+
+void Boost_Segment(float* Buf, int Stride, int num, float Drive, float BlendPow, const float* Table,
+                   t_BoostLevel& bl, float& Start, float& Step)
+{
+    float PreSq = 0.0f;
+    float PostSq = 0.0f;
+    for (int t = 0; t < num; t++)
+    {
+        float x = Buf[t * Stride];
+        float y = Table ? Osc_Sin(Table, uint32_t(int64_t(x * Drive * BOOST_ToPhase))) : sinf(x * Drive);
+        PreSq += x * x;
+        PostSq += y * y;
+        Buf[t * Stride] = y;
+    }
+
+    //R1.01 Smooth the levels across segments. Coming out of silence starts from this segment's levels.
+    bool Fresh = (bl.PostMS <= BOOST_Floor);
+    float Blend = Fresh ? 0.0f : BlendPow;
+    bl.PreMS = (bl.PreMS * Blend) + ((PreSq / num) * (1.0f - Blend));
+    bl.PostMS = (bl.PostMS * Blend) + ((PostSq / num) * (1.0f - Blend));
+
+    //R1.01 Makeup gain to bring the boosted level back to the level that went in. Held through silence.
+    float Target = bl.Makeup;
+    if (BOOST_Floor < bl.PostMS)
+    {
+        Target = sqrtf(bl.PreMS / bl.PostMS);
+        if (Target < BOOST_MakeupMin) Target = BOOST_MakeupMin;
+        if (BOOST_MakeupMax < Target) Target = BOOST_MakeupMax;
+    }
+    if (Fresh) bl.Makeup = Target;
+
+    //R1.01 Ramp from the last gain to the new one.
+    Start = bl.Makeup;
+    Step = (Target - bl.Makeup) / num;
+    bl.Makeup = Target;
+}
+
+void Delay_Mix(float* Buf, float* DB, int num, float Dry, float Wet, float Len)
+{
+    for (int t = 0; t < num; t++)
+    {
+        float x = Buf[t];
+        Buf[t] = (x * Dry) + (DB[t] * Wet);
+        DB[t] = (.5f * x) + (DB[t] * Len);
+    }
+}
+
+void Delay_Segment(float* Buf, int num, float* DB, size_t Size, int& Idx, int Max,
+                   float Dry, float Wet, float Len, t_DelayMix Mix)
+{
+    (void) Size;
+    while (0 < num)
+    {
+        //R1.01 Samples left before the index goes past the buffer limit and wraps to the start.
+        int Run = Max + 1 - Idx;
+        if (num < Run) Run = num;
+        if (Run < 1) Run = 1;
+        MAKO_BOUNDS(Idx, Run, Size, "Delay_B");
+
+        //R1.00 Mix our signal with the echo. Update the buffer with our new sample and old echo mixed.
+        //R1.00 We cant exceed -1/1 so we put in .5f sample volume. .5+.5 = 1 (safe).
+        Mix(Buf, DB + Idx, Run, Dry, Wet, Len);
+
+        Idx += Run;
+        if (Max < Idx) Idx = 0;
+        Buf += Run;
+        num -= Run;
+    }
+}
+
+void Gain_Ramp(const float* Src, float* Dest, int num, float Start, float Step)
+{
+    for (int t = 0; t < num; t++) Dest[t] = Src[t] * (Start + Step * (t + 1));
+}
+
+}
@@ -0,0 +1,192 @@
+/*
+  ==============================================================================
+
+    MakoDSP.h
+    Per channel DSP kernels shared by the plugin and the batch engine.
+    No JUCE, so MakoEngine and the Python module can use them too.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+
+//R1.01 SHARED DSP.
+//R1.01 One copy of the oscillators, voices, pitch tracker step, attack envelope, Boost and delay.
+//R1.01 PluginProcessor runs them on its tp_chanstate, one channel at a time. MakoEngine runs them on its
+//R1.01 per engine arrays, so kernels that read a segment take a Stride between samples.
+//R1.01 Only the state lives in the callers. A change to the sound is made here once.
+namespace MakoDSP
+{
+    const float pi = 3.14159265f;
+    const float pi2 = 6.2831853f;
+    const float sqrt2 = 1.4142135f;
+
+    //R1.01 OSCILLATOR CORE.
+    //R1.01 Our phase accumulator is a 32 bit integer that spans 4PI (two cycles), same range R1.00 used.
+    //R1.01 Sines come from a small table with linear interpolation. Squares use PolyBLEP to remove aliasing.
+    //R1.01 Osc_Sin takes an angle where 2^32 = 2PI, so phase << 1 is the fundamental, phase << 2 is 2x, etc.
+    static const int SIN_Bits = 12;
+    static const int SIN_Size = 1 << SIN_Bits;
+    const float PHASE_Scale = 341782637.8f;                  //R1.01 2^32 / 4PI. Radians to phase units.
+    const float PHASE_ToUnit = 2.3283064e-10f;               //R1.01 1 / 2^32.
+    const uint32_t OSC_Mult_158 = 207531;                    //R1.01 2 * 1.5833333 in 16.16 fixed point.
+    const uint32_t OSC_Mult_133 = 174862;                    //R1.01 2 * 1.3340909 in 16.16 fixed point.
+
+    //R1.01 Envelope times. These match the original .995 per sample values at 48 kHz.
+    const float ENV_Peak_ms = 4.1667f;        //R1.01 Mod_Peak release.
+    const float ENV_Avg_ms = 4.1667f;         //R1.01 Signal_AVG note on/off detector.
+    const float ENV_FadeOut_ms = 4.1667f;     //R1.01 Attack fade out.
+    const float ENV_Boost_ms = 60.0f;         //R1.01 Boost level smoothing.
+
+    //R1.01 BOOST MAKEUP. The synth level before and after Boost is measured once per segment as a mean
+    //R1.01 square, smoothed over ENV_Boost_ms, and the gain that matches them is ramped in across the segment.
+    //R1.01 One SQRTF per segment. Nothing is added per sample but a multiply.
+    const float BOOST_MakeupMin = .02f;       //R1.01 Small signals are boosted up to 50x by SINF. Allow that much cut.
+    const float BOOST_MakeupMax = 2.0f;
+    const float BOOST_Floor = 1.0e-8f;        //R1.01 Mean square below this is silence. Hold the gain.
+    const float BOOST_ToPhase = 683565275.6f; //R1.01 2^32 / 2PI. Radians to Osc_Sin angle.
+
+    struct t_BoostLevel {
+        float PreMS = 0.0f;                   //R1.01 Smoothed mean square before Boost.
+        float PostMS = 0.0f;                  //R1.01 Smoothed mean square after Boost.
+        float Makeup = 1.0f;                  //R1.01 Gain at the end of the last segment.
+    };
+
+    //R1.01 Biquad designs. c = a0 a1 a2 b1 b2.
+    void Coeffs_LP(float fc, float Rate, float* c);
+    void Coeffs_HP(float fc, float Rate, float* c);
+    void Coeffs_BP(float Gain_dB, float Fc, float Q, float Rate, float* c);
+
+    //R1.01 One sine cycle plus a guard point. Table must hold SIN_Size + 1 floats.
+    void Sin_Fill(float* Table);
+
+    //R1.01 One pole coefficient for a time in milliseconds, and its powers 0 - n so a segment
+    //R1.01 of N samples can be updated with one multiply.
+    float Env_Coef(float ms, float Rate);
+    void Env_Powers(float Coef, float* Pow, int n);
+
+    inline float Osc_Sin(const float* Table, uint32_t p)
+    {
+        uint32_t idx = p >> (32 - SIN_Bits);
+        float frac = float(p & ((1u << (32 - SIN_Bits)) - 1)) * (1.0f / float(1u << (32 - SIN_Bits)));
+        return Table[idx] + (Table[idx + 1] - Table[idx]) * frac;
+    }
+
+    //R1.01 Nearest table entry, no interpolation. Used by the plugin's quality governor.
+    inline float Osc_SinNearest(const float* Table, uint32_t p)
+    {
+        return Table[p >> (32 - SIN_Bits)];
+    }
+
+    //R1.01 Angle times a fixed point multiplier, wrapped to 2PI.
+    inline uint32_t Osc_Mult(uint32_t Phase, uint32_t Mult)
+    {
+        return uint32_t((uint64_t(Phase) * Mult) >> 16);
+    }
+
+    //R1.01 PolyBLEP correction. t = position in the cycle (0 - 1), dt = cycle step per sample.
+    inline float Osc_PolyBLEP(float t, float dt)
+    {
+        if (t < dt)
+        {
+            t /= dt;
+            return t + t - t * t - 1.0f;
+        }
+        if ((1.0f - dt) < t)
+        {
+            t = (t - 1.0f) / dt;
+            return t * t + t + t + 1.0f;
+        }
+        return 0.0f;
+    }
+
+    //R1.01 Band limited square. +1 for the first half of the cycle, -1 for the second.
+    inline float Osc_Square(uint32_t p, float dt)
+    {
+        float t = float(p) * PHASE_ToUnit;
+        float t2 = t + .5f;
+        if (1.0f <= t2) t2 -= 1.0f;
+
+        float v = (p < 0x80000000u) ? 1.0f : -1.0f;
+        return v + Osc_PolyBLEP(t, dt) - Osc_PolyBLEP(t2, dt);
+    }
+
+    //R1.00 Create the SINE wave gen signal for voices 1 - 10. ph is the phase, PhaseInc its step per sample.
+    //R1.01 Sines from our table, squares with PolyBLEP. No SINF calls per sample.
+    template <bool Nearest>
+    inline float Voice_Render(const float* Table, int Voice, uint32_t ph, uint32_t PhaseInc)
+    {
+        auto Sin = [Table](uint32_t p) { return Nearest ? Osc_SinNearest(Table, p) : Osc_Sin(Table, p); };
+        uint32_t p1 = ph << 1;                                                     //R1.01 Fundamental angle.
+        float dt = float(PhaseInc) * 2.0f * PHASE_ToUnit;                          //R1.01 Fundamental cycles per sample.
+        if (.5f < dt) dt = .5f;
+
+        switch (Voice)
+        {
+            case 1: return Sin(p1) + Sin(ph << 2);
+            case 2: return .75f * (Sin(p1 + 0x40000000u) + Sin(ph << 2) + Sin(Osc_Mult(ph, OSC_Mult_158)));
+            case 3: return .5f * Osc_Square(p1, dt);
+            case 4: return (Osc_Square(p1, dt) + Sin(ph << 3)) * .333f;
+            case 5: return Sin(p1) + Sin(Osc_Mult(ph, OSC_Mult_158));
+            case 6: return Sin(p1) + Sin(ph << 2);
+            case 7: return Sin(ph << 2) + (Sin(ph << 3) * .1f);
+            case 8: return Sin(p1) + (Sin(ph << 2) * .1f);
+            case 9: return Sin(ph) + (Sin(ph << 3) * .1f);
+            case 10: return (Osc_Square(ph, dt * .5f) + Sin(Osc_Mult(ph, OSC_Mult_133))) * .333f;
+
+            //R1.00 Default for when things go horribly wrong.
+            default: return 1.5f * Sin(p1);
+        }
+    }
+
+    //R1.00 Apply some psuedo compression to the peak value. To smooth out the picking dynamic range.
+    //R1.00 This func does not exeed -1/1 so it is volume safe.
+    inline float Peak_Level(float x, float PreGain)
+    {
+        return fabsf(tanhf(x * (.01f + PreGain) * 8.0f));
+    }
+
+    //R1.00 Blend new pitch with old for Glissando. Cnt is samples since the last rising zero crossing.
+    //R1.01 Gliss is shifted down by .01, so a big drop in pitch can blend to below 0. Never go backwards,
+    //R1.01 a negative float to unsigned conversion in Phase_Step is undefined.
+    inline float Pitch_Blend(float PitchInc, int Cnt, float Gliss)
+    {
+        float Inc = (PitchInc * Gliss) + ((pi2 / Cnt) * (1.0f - Gliss));
+        return (Inc < 0.0f) ? 0.0f : Inc;
+    }
+
+    //R1.01 Radians per sample to our integer phase step.
+    inline uint32_t Phase_Step(float PitchInc)
+    {
+        return uint32_t(PitchInc * PHASE_Scale);
+    }
+
+    //R1.00 ATTACK. A slow envelope attack for violin/synth effects.
+    //R1.01 Runs at segment rate over num samples of Src, Stride apart. AvgPow and FadePow are the
+    //R1.01 envelope coefficients to the power num, Inc the fade in per sample. Returns the gain ramp:
+    //R1.01 sample t gets Start + Step * (t + 1).
+    void Attack_Envelope(const float* Src, int Stride, int num, float AvgPow, float FadePow, float Inc,
+                         float& AVG, float& VolFade, char& VolFadeOn, float& Start, float& Step);
+
+    //R1.00 BOOST. Adds harmonics with SINF, in place over num samples of Buf, Stride apart.
+    //R1.01 Table = nullptr uses SINF, otherwise our sine table. BlendPow is the Boost envelope to the power num.
+    //R1.01 Returns the makeup gain ramp, applied by the caller with any balance folded in.
+    void Boost_Segment(float* Buf, int Stride, int num, float Drive, float BlendPow, const float* Table,
+                       t_BoostLevel& bl, float& Start, float& Step);
+
+    //R1.01 Out = x * Dry + DB * Wet, then DB = .5 * x + DB * Len. Buf is x in and Out out.
+    typedef void (*t_DelayMix)(float* Buf, float* DB, int num, float Dry, float Wet, float Len);
+    void Delay_Mix(float* Buf, float* DB, int num, float Dry, float Wet, float Len);
+
+    //R1.00 DIGITAL DELAY over a segment. Idx walks 0 - Max and wraps. DB holds Size floats.
+    //R1.01 Between wraps each buffer position is read and written once, so each run goes to Mix.
+    void Delay_Segment(float* Buf, int num, float* DB, size_t Size, int& Idx, int Max,
+                       float Dry, float Wet, float Len, t_DelayMix Mix);
+
+    //R1.01 Dest[t] = Src[t] * (Start + Step * (t + 1)).
+    void Gain_Ramp(const float* Src, float* Dest, int num, float Start, float Step);
+}
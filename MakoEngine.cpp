@@ -0,0 +1,299 @@
+/*
+  ==============================================================================
+
+    MakoEngine.cpp
+    The MonoTone DSP without JUCE. Runs many independent mono tracks at
+    once for offline rendering. No editor, no APVTS, no host.
+
+  ==============================================================================
+*/
+
+#include "MakoEngine.h"
+#include <algorithm>
+#include <cmath>
+
+void MakoEngine::Prepare(int Engines, double SampleRate)
+{
+    Eng_Cnt = std::max(0, Engines);
+    Lanes = (Eng_Cnt + 15) & ~15;
+    Rate = float(SampleRate);
+    if (Rate < 21000.0f) Rate = 48000.0f;
+
+    MakoDSP::Sin_Fill(SIN_Table);
+
+    Env_PeakCoef = MakoDSP::Env_Coef(MakoDSP::ENV_Peak_ms, Rate);
+    MakoDSP::Env_Powers(MakoDSP::Env_Coef(MakoDSP::ENV_Avg_ms, Rate), Env_AvgPow, SEG_Size);
+    MakoDSP::Env_Powers(MakoDSP::Env_Coef(MakoDSP::ENV_FadeOut_ms, Rate), Env_FadePow, SEG_Size);
+    MakoDSP::Env_Powers(MakoDSP::Env_Coef(MakoDSP::ENV_Boost_ms, Rate), Env_BoostPow, SEG_Size);
+
+    //R1.01 Every array is Lanes long. Lanes past Eng_Cnt are zero and never used.
+    size_t L = size_t(Lanes);
+    for (std::vector<float>* v : { &S_Gain, &S_Gliss, &S_Mix, &S_PreGain, &S_Boost, &S_DLen, &S_Dry, &S_Wet, &S_AttackInc,
+                                   &Mod_PitchInc, &Mod_Peak, &Mod_LastSample, &Signal_VolFade, &Signal_AVG,
+                                   &W_Vol, &W_VolStep })
+        v->assign(L, 0.0f);
+    for (int s = 0; s < BQ_Stages; s++)
+    {
+        for (int k = 0; k < 5; k++) Bq_Coef[s][k].assign(L, 0.0f);
+        Bq_X1[s].assign(L, 0.0f); Bq_X2[s].assign(L, 0.0f); Bq_Y1[s].assign(L, 0.0f); Bq_Y2[s].assign(L, 0.0f);
+    }
+    Mod_Phase.assign(L, 0);
+    Mod_PhaseInc.assign(L, 0);
+    Mod_PitchCnt.assign(L, 0);
+    Signal_VolFadeOn.assign(L, 0);
+    Boost_Level.assign(L, MakoDSP::t_BoostLevel());
+    S_Voice.assign(L, 0);
+
+    for (std::vector<float>* v : { &W_In, &W_Att, &W_Ana, &W_Syn, &W_Peak }) v->assign(L * SEG_Size, 0.0f);
+    W_Phase.assign(L * SEG_Size, 0);
+    W_PhaseInc.assign(L * SEG_Size, 0);
+
+    Parms.assign(size_t(Eng_Cnt), t_Parms());
+    Delay_B.assign(size_t(Eng_Cnt), std::vector<float>());
+    Delay_Idx.assign(size_t(Eng_Cnt), 0);
+    Delay_Max.assign(size_t(Eng_Cnt), 0);
+
+    //R1.01 Fixed LoCut. The Low Pass stages are set with the rest of each engine's settings.
+    float c[5];
+    MakoDSP::Coeffs_HP(40.0f, Rate, c);
+    for (int e = 0; e < Eng_Cnt; e++)
+    {
+        for (int k = 0; k < 5; k++) Bq_Coef[0][k][e] = c[k];
+        Parms_Set(e, t_Parms());
+        Reset(e);
+    }
+}
+
+void MakoEngine::Reset(int e)
+{
+    if ((e < 0) || (Eng_Cnt <= e)) return;
+
+    for (int s = 0; s < BQ_Stages; s++) Bq_X1[s][e] = Bq_X2[s][e] = Bq_Y1[s][e] = Bq_Y2[s][e] = 0.0f;
+    Mod_Phase[e] = 0;
+    Mod_PhaseInc[e] = 0;
+    Mod_PitchCnt[e] = 0;
+    Mod_PitchInc[e] = 0.0f;
+    Mod_Peak[e] = 0.0f;
+    Mod_LastSample[e] = 0.0f;
+    Signal_VolFade[e] = 0.0f;
+    Signal_AVG[e] = 0.0f;
+    Signal_VolFadeOn[e] = 0;
+    Boost_Level[e] = MakoDSP::t_BoostLevel();
+    std::fill(Delay_B[e].begin(), Delay_B[e].end(), 0.0f);
+    Delay_Idx[e] = Delay_Max[e] - 1;
+}
+
+void MakoEngine::Parms_Set(int e, const t_Parms& P)
+{
+    if ((e < 0) || (Eng_Cnt <= e)) return;
+    t_Parms Old = Parms[e];
+    Parms[e] = P;
+    Parms[e].Voice = std::min(10, std::max(0, P.Voice));
+
+    S_Gain[e] = P.Gain;
+    S_Voice[e] = Parms[e].Voice;
+    S_Gliss[e] = P.Gliss - .01f;
+    S_Mix[e] = (.001f <= P.Mix) ? P.Mix : 0.0f;
+    S_PreGain[e] = P.PreGain;
+    S_Boost[e] = P.Boost;
+    S_DLen[e] = P.DLen;
+    S_AttackInc[e] = (.048f + (1.0f - P.Attack) * 4.8f) / Rate;
+
+    //R2.00 Adjust the DELAY mix.
+    S_Dry[e] = (P.DMix < .5f) ? 1.0f : 1.0f - ((P.DMix - .5f) * 2.0f);
+    S_Wet[e] = (P.DMix < .5f) ? P.DMix * 2 : 1.0f;
+
+    float c[5];
+    MakoDSP::Coeffs_LP(std::min(500.0f, std::max(50.0f, float(int(P.LP + .5f)))), Rate, c);
+    for (int s = 1; s < BQ_Stages; s++)
+        for (int k = 0; k < 5; k++) Bq_Coef[s][k][e] = c[k];
+
+    //R1.01 Delay line is only as long as this engine needs. Delay Time * 2 seconds.
+    int Len = std::max(0, int(2 * P.DTime * Rate));
+    if (Delay_B[e].size() < size_t(Len + 2)) Delay_B[e].resize(size_t(Len + 2), 0.0f);
+    if ((Len + 1 != Delay_Max[e]) || (Old.DTime != P.DTime))
+    {
+        Delay_Idx[e] = Len;
+        Delay_Max[e] = Len + 1;
+    }
+
+    //R1.01 Stages coming back on start from silence, like the plugin.
+    if ((Old.DMix < .001f) && (.001f <= P.DMix)) std::fill(Delay_B[e].begin(), Delay_B[e].end(), 0.0f);
+    bool WasSynth = (Old.Voice != 0) && (.001f <= Old.Mix);
+    if (!WasSynth && Synth_On(e))
+    {
+        Mod_PitchCnt[e] = 0;
+        Mod_Peak[e] = 0.0f;
+        Mod_LastSample[e] = 0.0f;
+        for (int s = 0; s < BQ_Stages; s++) Bq_X1[s][e] = Bq_X2[s][e] = Bq_Y1[s][e] = Bq_Y2[s][e] = 0.0f;
+    }
+    if ((Old.Mix < .001f) && (.001f <= P.Mix))
+    {
+        Signal_VolFade[e] = 0.0f;
+        Signal_AVG[e] = 0.0f;
+        Signal_VolFadeOn[e] = 0;
+    }
+}
+
+float MakoEngine::Track_Freq(int e) const
+{
+    if ((e < 0) || (Eng_Cnt <= e)) return 0.0f;
+    return Mod_PitchInc[e] * Rate / MakoDSP::pi2;
+}
+
+void MakoEngine::Process(float* const* Tracks, int num)
+{
+    for (int pos = 0; pos < num; pos += SEG_Size)
+        Segment(Tracks, pos, std::min(int(SEG_Size), num - pos));
+}
+
+//R1.01 One segment of every engine. Work areas are [sample][engine] so inner loops run across engines.
+void MakoEngine::Segment(float* const* Tracks, int pos, int num)
+{
+    const int L = Lanes;
+
+    //R1.01 Tracks in.
+    for (int e = 0; e < Eng_Cnt; e++)
+    {
+        const float* Src = Tracks[e] + pos;
+        for (int t = 0; t < num; t++) W_In[t * L + e] = Src[t];
+    }
+
+    //R1.00 ATTACK.
+    Attack_Segment(num);
+
+    //R1.01 Pitch analysis filters. Each stage runs across all engines at once.
+    for (int s = 0; s < BQ_Stages; s++)
+    {
+        const float* a0 = Bq_Coef[s][0].data(); const float* a1 = Bq_Coef[s][1].data(); const float* a2 = Bq_Coef[s][2].data();
+        const float* b1 = Bq_Coef[s][3].data(); const float* b2 = Bq_Coef[s][4].data();
+        float* x1 = Bq_X1[s].data(); float* x2 = Bq_X2[s].data(); float* y1 = Bq_Y1[s].data(); float* y2 = Bq_Y2[s].data();
+        const float* Src = (s == 0) ? W_Att.data() : W_Ana.data();
+        float* Dest = W_Ana.data();
+
+        for (int t = 0; t < num; t++)
+        {
+            const float* In = Src + t * L;
+            float* Out = Dest + t * L;
+            for (int e = 0; e < L; e++)
+            {
+                float x = In[e];
+                float y = a0[e] * x + a1[e] * x1[e] + a2[e] * x2[e] - b1[e] * y1[e] - b2[e] * y2[e];
+                x2[e] = x1[e]; x1[e] = x;
+                y2[e] = y1[e]; y1[e] = y;
+                Out[e] = y;
+            }
+        }
+    }
+
+    //R1.00 VOLUME ENVELOPE and PITCH DETECTION, branch free across engines.
+    for (int t = 0; t < num; t++)
+    {
+        const float* Att = W_Att.data() + t * L;
+        const float* Ana = W_Ana.data() + t * L;
+        float* Peak = W_Peak.data() + t * L;
+        uint32_t* Ph = W_Phase.data() + t * L;
+        uint32_t* PhInc = W_PhaseInc.data() + t * L;
+
+        for (int e = 0; e < L; e++)
+        {
+            float tP = MakoDSP::Peak_Level(Att[e], S_PreGain[e]);
+            Mod_Peak[e] = std::max(Mod_Peak[e] * Env_PeakCoef, tP);
+
+            int Cnt = Mod_PitchCnt[e] + 1;
+            bool Cross = (Mod_LastSample[e] < 0.0f) && (0.0f < Ana[e]);
+            float Inc = MakoDSP::Pitch_Blend(Mod_PitchInc[e], Cnt, S_Gliss[e]);
+            Mod_PitchInc[e] = Cross ? Inc : Mod_PitchInc[e];
+            Mod_PhaseInc[e] = Cross ? MakoDSP::Phase_Step(Inc) : Mod_PhaseInc[e];
+            Mod_PitchCnt[e] = Cross ? 0 : Cnt;
+            Mod_LastSample[e] = Ana[e];
+
+            Mod_Phase[e] += Mod_PhaseInc[e];
+            Peak[e] = Mod_Peak[e];
+            Ph[e] = Mod_Phase[e];
+            PhInc[e] = Mod_PhaseInc[e];
+        }
+    }
+
+    //R1.00 SYNTH SOUND GENERATION. Each engine can have a different voice so this runs per engine.
+    for (int e = 0; e < Eng_Cnt; e++)
+    {
+        if (!Synth_On(e))
+        {
+            for (int t = 0; t < num; t++) W_Syn[t * L + e] = W_Att[t * L + e];
+            continue;
+        }
+
+        int Voice = S_Voice[e];
+        for (int t = 0; t < num; t++)
+        {
+            int i = t * L + e;
+            W_Syn[i] = MakoDSP::Voice_Render<false>(SIN_Table, Voice, W_Phase[i], W_PhaseInc[i]) * W_Peak[i];
+        }
+        Boost_Segment(e, num);
+    }
+
+    //R1.00 Mix original sample and new modified synth sample, then halve it.
+    for (int t = 0; t < num; t++)
+    {
+        const float* In = W_In.data() + t * L;
+        const float* Syn = W_Syn.data() + t * L;
+        float* Out = W_Att.data() + t * L;
+        for (int e = 0; e < L; e++) Out[e] = ((In[e] * (1.0f - S_Mix[e])) + (Syn[e] * S_Mix[e])) * .5f;
+    }
+
+    //R1.00 DIGITAL DELAY and GAIN, per engine, straight back into the track.
+    for (int e = 0; e < Eng_Cnt; e++)
+    {
+        float* Dest = Tracks[e] + pos;
+        for (int t = 0; t < num; t++) Dest[t] = W_Att[t * L + e];
+        if (.001f <= Parms[e].DMix)
+            MakoDSP::Delay_Segment(Dest, num, Delay_B[e].data(), Delay_B[e].size(), Delay_Idx[e], Delay_Max[e],
+                                   S_Dry[e], S_Wet[e], S_DLen[e], MakoDSP::Delay_Mix);
+
+        float Gain = S_Gain[e];
+        for (int t = 0; t < num; t++) Dest[t] *= Gain;
+    }
+}
+
+//R1.00 ATTACK. The envelope runs at segment rate per engine, the ramp runs across engines.
+void MakoEngine::Attack_Segment(int num)
+{
+    const int L = Lanes;
+
+    for (int e = 0; e < Eng_Cnt; e++)
+    {
+        if ((Parms[e].Attack < .001f) || (S_Mix[e] <= 0.0f))
+        {
+            W_Vol[e] = 1.0f;
+            W_VolStep[e] = 0.0f;
+            continue;
+        }
+
+        MakoDSP::Attack_Envelope(W_In.data() + e, L, num, Env_AvgPow[num], Env_FadePow[num], S_AttackInc[e],
+                                 Signal_AVG[e], Signal_VolFade[e], Signal_VolFadeOn[e], W_Vol[e], W_VolStep[e]);
+    }
+
+    for (int t = 0; t < num; t++)
+    {
+        const float* In = W_In.data() + t * L;
+        float* Out = W_Att.data() + t * L;
+        float k = float(t + 1);
+        for (int e = 0; e < L; e++) Out[e] = In[e] * (W_Vol[e] + W_VolStep[e] * k);
+    }
+}
+
+//R1.00 BOOST with the plugin's segment rate makeup gain.
+void MakoEngine::Boost_Segment(int e, int num)
+{
+    const int L = Lanes;
+    if (S_Boost[e] <= 0.0f)
+    {
+        Boost_Level[e] = MakoDSP::t_BoostLevel();
+        return;
+    }
+
+    float Start, Step;
+    MakoDSP::Boost_Segment(W_Syn.data() + e, L, num, S_Boost[e] * 50.0f, Env_BoostPow[num], nullptr, Boost_Level[e], Start, Step);
+    for (int t = 0; t < num; t++) W_Syn[t * L + e] *= Start + Step * (t + 1);
+}
@@ -0,0 +1,102 @@
+/*
+  ==============================================================================
+
+    MakoEngine.h
+    The MonoTone DSP without JUCE. Runs many independent mono tracks at
+    once for offline rendering. No editor, no APVTS, no host.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "MakoDSP.h"
+
+//R1.01 BATCH ENGINE.
+//R1.01 One MakoEngine holds N engines, one per track. Every engine has its own settings and state,
+//R1.01 and Process advances all of them by the same number of samples in one call.
+//R1.01 State is stored one array per variable, indexed by engine (struct of arrays). The inner loops run
+//R1.01 across engines, so the filters, pitch trackers, envelopes and mix are vectorized over tracks.
+//R1.01 Voices and delay lines are per engine and run one engine at a time.
+//R1.01 The voices, tracker step, attack envelope, Boost and delay are the plugin's own code in MakoDSP.h.
+//R1.01 Same sound as the plugin for a mono track with Balance centered. Left out: MIDI out, the sample
+//R1.01 voice (11), sample accurate automation and filter glides. Settings change between Process calls.
+class MakoEngine
+{
+public:
+    //R1.01 Settings for one engine. Same ranges as the plugin knobs.
+    struct t_Parms {
+        float Gain = 1.0f;
+        int Voice = 1;             //R1.01 0 - 10.
+        float Gliss = .24f;
+        float Mix = 1.0f;
+        float LP = 200.0f;         //R1.01 50 - 500 Hz.
+        float Boost = 0.0f;
+        float PreGain = .2f;
+        float Attack = 0.0f;
+        float DTime = .4f;
+        float DLen = .2f;
+        float DMix = .1f;
+    };
+
+    //R1.01 Not real time. Sizes every engine for this rate and clears them.
+    void Prepare(int Engines, double SampleRate);
+
+    //R1.01 Not real time. A longer Delay Time grows that engine's delay line.
+    void Parms_Set(int e, const t_Parms& P);
+    void Reset(int e);
+
+    //R1.01 Advance every engine by num samples. Tracks[e] is engine e's audio, processed in place.
+    void Process(float* const* Tracks, int num);
+
+    int Engines_Get() const { return Eng_Cnt; }
+
+    //R1.01 Pitch engine e is tracking in Hz. 0 = nothing tracked yet.
+    float Track_Freq(int e) const;
+
+private:
+    static const int SEG_Size = 32;            //R1.01 Same segment size as the plugin.
+    static const int LP_Stages = 2;            //R1.01 Same analysis chain as the plugin. LoCut + 2 Low Pass.
+    static const int BQ_Stages = LP_Stages + 1;
+
+    int Eng_Cnt = 0;
+    int Lanes = 0;                             //R1.01 Eng_Cnt rounded up to 16 so vector loops have no tails.
+    float Rate = 48000.0f;
+
+    //R1.01 SETTINGS per engine.
+    std::vector<t_Parms> Parms;
+    std::vector<float> S_Gain, S_Gliss, S_Mix, S_PreGain, S_Boost, S_DLen, S_Dry, S_Wet, S_AttackInc;
+    std::vector<int> S_Voice;
+    std::vector<float> Bq_Coef[BQ_Stages][5];
+
+    //R1.01 STATE per engine.
+    std::vector<float> Bq_X1[BQ_Stages], Bq_X2[BQ_Stages], Bq_Y1[BQ_Stages], Bq_Y2[BQ_Stages];
+    std::vector<uint32_t> Mod_Phase, Mod_PhaseInc;
+    std::vector<int> Mod_PitchCnt;
+    std::vector<float> Mod_PitchInc, Mod_Peak, Mod_LastSample;
+    std::vector<float> Signal_VolFade, Signal_AVG;
+    std::vector<char> Signal_VolFadeOn;
+    std::vector<MakoDSP::t_BoostLevel> Boost_Level;
+    std::vector<std::vector<float>> Delay_B;
+    std::vector<int> Delay_Idx, Delay_Max;
+
+    //R1.01 Segment work areas, [sample][engine].
+    std::vector<float> W_In, W_Att, W_Ana, W_Syn, W_Peak;
+    std::vector<uint32_t> W_Phase, W_PhaseInc;
+    std::vector<float> W_Vol, W_VolStep;      //R1.01 [engine]. Attack ramp for this segment.
+
+    //R1.01 Envelope coefficients, same times as the plugin.
+    float Env_PeakCoef = 0.0f;
+    float Env_AvgPow[SEG_Size + 1] = {};
+    float Env_FadePow[SEG_Size + 1] = {};
+    float Env_BoostPow[SEG_Size + 1] = {};
+
+    float SIN_Table[MakoDSP::SIN_Size + 1] = {};
+
+    void Segment(float* const* Tracks, int pos, int num);
+    void Attack_Segment(int num);
+    void Boost_Segment(int e, int num);
+    bool Synth_On(int e) const { return (Parms[e].Voice != 0) && (.001f <= Parms[e].Mix); }
+};
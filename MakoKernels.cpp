@@ -0,0 +1,442 @@
+/*
+  ==============================================================================
+
+    MakoKernels.cpp
+    Block DSP kernels built for several instruction sets. The best set for
+    the CPU we are running on is picked once when the plugin loads.
+
+  ==============================================================================
+*/
+
+#include "MakoKernels.h"
+#include "MakoDSP.h"
+
+#if MAKO_X86
+ #include <immintrin.h>
+#endif
+
+//R1.01 GCC and Clang need each function told which instruction set it may use. MSVC allows any
+//R1.01 intrinsic anywhere. fp-contract=off stops GCC from fusing our multiply and add into FMA,
+//R1.01 which would change the result bits.
+#if defined(__clang__)
+ #define MAKO_TARGET(isa) __attribute__((target(isa)))
+#elif defined(__GNUC__)
+ #define MAKO_TARGET(isa) __attribute__((target(isa), optimize("fp-contract=off")))
+#else
+ #define MAKO_TARGET(isa)
+#endif
+
+//==============================================================================
+//R1.01 GENERIC. Plain C++. Works on every CPU and is what the other sets must match.
+//R1.01 Gain_Ramp and Delay_Mix are the MakoDSP ones, so MakoEngine runs the same code.
+static void Gen_Biquad_Chain(const float* Src, float* Dest, int num, const float (*Coef)[5], float (*Hist)[4], int Stages)
+{
+    //R1.01 Load coefficients and history into locals.
+    float a0[KERN_MaxStages], a1[KERN_MaxStages], a2[KERN_MaxStages], b1[KERN_MaxStages], b2[KERN_MaxStages];
+    float x1[KERN_MaxStages], x2[KERN_MaxStages], y1[KERN_MaxStages], y2[KERN_MaxStages];
+    for (int st = 0; st < Stages; st++)
+    {
+        a0[st] = Coef[st][0]; a1[st] = Coef[st][1]; a2[st] = Coef[st][2]; b1[st] = Coef[st][3]; b2[st] = Coef[st][4];
+        x1[st] = Hist[st][0]; x2[st] = Hist[st][1]; y1[st] = Hist[st][2]; y2[st] = Hist[st][3];
+    }
+
+    for (int t = 0; t < num; t++)
+    {
+        float tS = Src[t];
+        for (int st = 0; st < Stages; st++)
+        {
+            float y = a0[st] * tS + a1[st] * x1[st] + a2[st] * x2[st] - b1[st] * y1[st] - b2[st] * y2[st];
+            x2[st] = x1[st]; x1[st] = tS;
+            y2[st] = y1[st]; y1[st] = y;
+            tS = y;
+        }
+        Dest[t] = tS;
+    }
+
+    //R1.01 Store the history back.
+    for (int st = 0; st < Stages; st++)
+    {
+        Hist[st][0] = x1[st]; Hist[st][1] = x2[st]; Hist[st][2] = y1[st]; Hist[st][3] = y2[st];
+    }
+}
+
+static void Gen_Mix_Half(float* Dest, const float* Wet, int num, float Mix)
+{
+    float Dry = 1.0f - Mix;
+    for (int t = 0; t < num; t++) Dest[t] = ((Dest[t] * Dry) + (Wet[t] * Mix)) * .5f;
+}
+
+static void Gen_Scale(float* Dest, int num, float Gain)
+{
+    for (int t = 0; t < num; t++) Dest[t] *= Gain;
+}
+
+static void Gen_Copy(float* Dest, const float* Src, int num)
+{
+    for (int t = 0; t < num; t++) Dest[t] = Src[t];
+}
+
+#if MAKO_X86
+
+//==============================================================================
+//R1.01 SSE2. 4 floats at a time.
+//R1.01 A biquad needs the last output before it can make the next one, so samples can not run side by side.
+//R1.01 The stages can. Lane s runs stage s one sample behind lane s-1, so a 4 stage chain costs one
+//R1.01 vector step per sample. The first and last Stages-1 steps are masked while the pipe fills and empties.
+MAKO_TARGET("sse2")
+static inline __m128 SSE2_Select(__m128 Mask, __m128 a, __m128 b)
+{
+    return _mm_or_ps(_mm_and_ps(Mask, a), _mm_andnot_ps(Mask, b));
+}
+
+MAKO_TARGET("sse2")
+static void SSE2_Biquad_Chain(const float* Src, float* Dest, int num, const float (*Coef)[5], float (*Hist)[4], int Stages)
+{
+    if (4 < Stages)
+    {
+        Gen_Biquad_Chain(Src, Dest, num, Coef, Hist, Stages);
+        return;
+    }
+
+    //R1.01 Stage s goes in lane s. Unused lanes have zero coefficients and stay silent.
+    alignas(16) float c[5][4] = {};
+    alignas(16) float h[4][4] = {};
+    for (int st = 0; st < Stages; st++)
+    {
+        for (int k = 0; k < 5; k++) c[k][st] = Coef[st][k];
+        for (int k = 0; k < 4; k++) h[k][st] = Hist[st][k];
+    }
+
+    __m128 a0 = _mm_load_ps(c[0]), a1 = _mm_load_ps(c[1]), a2 = _mm_load_ps(c[2]), b1 = _mm_load_ps(c[3]), b2 = _mm_load_ps(c[4]);
+    __m128 x1 = _mm_load_ps(h[0]), x2 = _mm_load_ps(h[1]), y1 = _mm_load_ps(h[2]), y2 = _mm_load_ps(h[3]);
+    const __m128i Lane = _mm_set_epi32(3, 2, 1, 0);
+    const __m128i Num = _mm_set1_epi32(num);
+    const int Last = Stages - 1;
+    alignas(16) float Out[4];
+
+    for (int k = 0; k < num + Last; k++)
+    {
+        //R1.01 Each lane's input is the previous step's output of the lane below. Lane 0 gets the new sample.
+        __m128 x = _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(y1), 4));
+        x = _mm_move_ss(x, _mm_set_ss((k < num) ? Src[k] : 0.0f));
+
+        __m128 y = _mm_sub_ps(_mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(a0, x), _mm_mul_ps(a1, x1)), _mm_mul_ps(a2, x2)),
+                                         _mm_mul_ps(b1, y1)), _mm_mul_ps(b2, y2));
+
+        if ((k < Last) || (num <= k))
+        {
+            //R1.01 Pipe filling or emptying. Only lanes working on a real sample (0 <= k - lane < num) keep their result.
+            __m128i Idx = _mm_sub_epi32(_mm_set1_epi32(k), Lane);
+            __m128 m = _mm_castsi128_ps(_mm_andnot_si128(_mm_cmplt_epi32(Idx, _mm_setzero_si128()), _mm_cmplt_epi32(Idx, Num)));
+            x2 = SSE2_Select(m, x1, x2);
+            x1 = SSE2_Select(m, x, x1);
+            y2 = SSE2_Select(m, y1, y2);
+            y1 = SSE2_Select(m, y, y1);
+        }
+        else
+        {
+            x2 = x1; x1 = x;
+            y2 = y1; y1 = y;
+        }
+
+        if (Last <= k)
+        {
+            _mm_store_ps(Out, y);
+            Dest[k - Last] = Out[Last];
+        }
+    }
+
+    _mm_store_ps(h[0], x1); _mm_store_ps(h[1], x2); _mm_store_ps(h[2], y1); _mm_store_ps(h[3], y2);
+    for (int st = 0; st < Stages; st++)
+        for (int k = 0; k < 4; k++) Hist[st][k] = h[k][st];
+}
+
+MAKO_TARGET("sse2")
+static void SSE2_Gain_Ramp(const float* Src, float* Dest, int num, float Start, float Step)
+{
+    const __m128 vStart = _mm_set1_ps(Start), vStep = _mm_set1_ps(Step), One = _mm_set_ps(4.0f, 3.0f, 2.0f, 1.0f);
+    int t = 0;
+    for (; t + 4 <= num; t += 4)
+    {
+        __m128 Vol = _mm_add_ps(vStart, _mm_mul_ps(vStep, _mm_add_ps(One, _mm_set1_ps(float(t)))));
+        _mm_storeu_ps(Dest + t, _mm_mul_ps(_mm_loadu_ps(Src + t), Vol));
+    }
+    for (; t < num; t++) Dest[t] = Src[t] * (Start + Step * (t + 1));
+}
+
+MAKO_TARGET("sse2")
+static void SSE2_Mix_Half(float* Dest, const float* Wet, int num, float Mix)
+{
+    float Dry = 1.0f - Mix;
+    const __m128 vDry = _mm_set1_ps(Dry), vMix = _mm_set1_ps(Mix), Half = _mm_set1_ps(.5f);
+    int t = 0;
+    for (; t + 4 <= num; t += 4)
+    {
+        __m128 v = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(Dest + t), vDry), _mm_mul_ps(_mm_loadu_ps(Wet + t), vMix));
+        _mm_storeu_ps(Dest + t, _mm_mul_ps(v, Half));
+    }
+    for (; t < num; t++) Dest[t] = ((Dest[t] * Dry) + (Wet[t] * Mix)) * .5f;
+}
+
+MAKO_TARGET("sse2")
+static void SSE2_Scale(float* Dest, int num, float Gain)
+{
+    const __m128 vGain = _mm_set1_ps(Gain);
+    int t = 0;
+    for (; t + 4 <= num; t += 4) _mm_storeu_ps(Dest + t, _mm_mul_ps(_mm_loadu_ps(Dest + t), vGain));
+    for (; t < num; t++) Dest[t] *= Gain;
+}
+
+MAKO_TARGET("sse2")
+static void SSE2_Copy(float* Dest, const float* Src, int num)
+{
+    int t = 0;
+    for (; t + 4 <= num; t += 4) _mm_storeu_ps(Dest + t, _mm_loadu_ps(Src + t));
+    for (; t < num; t++) Dest[t] = Src[t];
+}
+
+MAKO_TARGET("sse2")
+static void SSE2_Delay_Mix(float* Buf, float* DB, int num, float Dry, float Wet, float Len)
+{
+    const __m128 vDry = _mm_set1_ps(Dry), vWet = _mm_set1_ps(Wet), vLen = _mm_set1_ps(Len), Half = _mm_set1_ps(.5f);
+    int t = 0;
+    for (; t + 4 <= num; t += 4)
+    {
+        __m128 x = _mm_loadu_ps(Buf + t);
+        __m128 d = _mm_loadu_ps(DB + t);
+        _mm_storeu_ps(Buf + t, _mm_add_ps(_mm_mul_ps(x, vDry), _mm_mul_ps(d, vWet)));
+        _mm_storeu_ps(DB + t, _mm_add_ps(_mm_mul_ps(Half, x), _mm_mul_ps(d, vLen)));
+    }
+    MakoDSP::Delay_Mix(Buf + t, DB + t, num - t, Dry, Wet, Len);
+}
+
+//==============================================================================
+//R1.01 AVX2. 8 floats at a time. The biquad pipe stays 4 lanes wide but uses FMA, one rounding per
+//R1.01 multiply add instead of two. That is the one kernel that does not match generic bit for bit.
+MAKO_TARGET("avx2,fma")
+static void AVX2_Biquad_Chain(const float* Src, float* Dest, int num, const float (*Coef)[5], float (*Hist)[4], int Stages)
+{
+    if (4 < Stages)
+    {
+        Gen_Biquad_Chain(Src, Dest, num, Coef, Hist, Stages);
+        return;
+    }
+
+    alignas(16) float c[5][4] = {};
+    alignas(16) float h[4][4] = {};
+    for (int st = 0; st < Stages; st++)
+    {
+        for (int k = 0; k < 5; k++) c[k][st] = Coef[st][k];
+        for (int k = 0; k < 4; k++) h[k][st] = Hist[st][k];
+    }
+
+    __m128 a0 = _mm_load_ps(c[0]), a1 = _mm_load_ps(c[1]), a2 = _mm_load_ps(c[2]), b1 = _mm_load_ps(c[3]), b2 = _mm_load_ps(c[4]);
+    __m128 x1 = _mm_load_ps(h[0]), x2 = _mm_load_ps(h[1]), y1 = _mm_load_ps(h[2]), y2 = _mm_load_ps(h[3]);
+    const __m128i Lane = _mm_set_epi32(3, 2, 1, 0);
+    const __m128i Num = _mm_set1_epi32(num);
+    const int Last = Stages - 1;
+    alignas(16) float Out[4];
+
+    for (int k = 0; k < num + Last; k++)
+    {
+        __m128 x = _mm_castsi128_ps(_mm_slli_si128(_mm_castps_si128(y1), 4));
+        x = _mm_move_ss(x, _mm_set_ss((k < num) ? Src[k] : 0.0f));
+
+        __m128 y = _mm_fmadd_ps(a2, x2, _mm_fmadd_ps(a1, x1, _mm_mul_ps(a0, x)));
+        y = _mm_fnmadd_ps(b2, y2, _mm_fnmadd_ps(b1, y1, y));
+
+        if ((k < Last) || (num <= k))
+        {
+            __m128i Idx = _mm_sub_epi32(_mm_set1_epi32(k), Lane);
+            __m128 m = _mm_castsi128_ps(_mm_andnot_si128(_mm_cmplt_epi32(Idx, _mm_setzero_si128()), _mm_cmplt_epi32(Idx, Num)));
+            x2 = _mm_blendv_ps(x2, x1, m);
+            x1 = _mm_blendv_ps(x1, x, m);
+            y2 = _mm_blendv_ps(y2, y1, m);
+            y1 = _mm_blendv_ps(y1, y, m);
+        }
+        else
+        {
+            x2 = x1; x1 = x;
+            y2 = y1; y1 = y;
+        }
+
+        if (Last <= k)
+        {
+            _mm_store_ps(Out, y);
+            Dest[k - Last] = Out[Last];
+        }
+    }
+
+    _mm_store_ps(h[0], x1); _mm_store_ps(h[1], x2); _mm_store_ps(h[2], y1); _mm_store_ps(h[3], y2);
+    for (int st = 0; st < Stages; st++)
+        for (int k = 0; k < 4; k++) Hist[st][k] = h[k][st];
+}
+
+MAKO_TARGET("avx2")
+static void AVX2_Gain_Ramp(const float* Src, float* Dest, int num, float Start, float Step)
+{
+    const __m256 vStart = _mm256_set1_ps(Start), vStep = _mm256_set1_ps(Step);
+    const __m256 One = _mm256_set_ps(8.0f, 7.0f, 6.0f, 5.0f, 4.0f, 3.0f, 2.0f, 1.0f);
+    int t = 0;
+    for (; t + 8 <= num; t += 8)
+    {
+        __m256 Vol = _mm256_add_ps(vStart, _mm256_mul_ps(vStep, _mm256_add_ps(One, _mm256_set1_ps(float(t)))));
+        _mm256_storeu_ps(Dest + t, _mm256_mul_ps(_mm256_loadu_ps(Src + t), Vol));
+    }
+    for (; t < num; t++) Dest[t] = Src[t] * (Start + Step * (t + 1));
+}
+
+MAKO_TARGET("avx2")
+static void AVX2_Mix_Half(float* Dest, const float* Wet, int num, float Mix)
+{
+    float Dry = 1.0f - Mix;
+    const __m256 vDry = _mm256_set1_ps(Dry), vMix = _mm256_set1_ps(Mix), Half = _mm256_set1_ps(.5f);
+    int t = 0;
+    for (; t + 8 <= num; t += 8)
+    {
+        __m256 v = _mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(Dest + t), vDry), _mm256_mul_ps(_mm256_loadu_ps(Wet + t), vMix));
+        _mm256_storeu_ps(Dest + t, _mm256_mul_ps(v, Half));
+    }
+    for (; t < num; t++) Dest[t] = ((Dest[t] * Dry) + (Wet[t] * Mix)) * .5f;
+}
+
+MAKO_TARGET("avx2")
+static void AVX2_Scale(float* Dest, int num, float Gain)
+{
+    const __m256 vGain = _mm256_set1_ps(Gain);
+    int t = 0;
+    for (; t + 8 <= num; t += 8) _mm256_storeu_ps(Dest + t, _mm256_mul_ps(_mm256_loadu_ps(Dest + t), vGain));
+    for (; t < num; t++) Dest[t] *= Gain;
+}
+
+MAKO_TARGET("avx2")
+static void AVX2_Copy(float* Dest, const float* Src, int num)
+{
+    int t = 0;
+    for (; t + 8 <= num; t += 8) _mm256_storeu_ps(Dest + t, _mm256_loadu_ps(Src + t));
+    for (; t < num; t++) Dest[t] = Src[t];
+}
+
+MAKO_TARGET("avx2")
+static void AVX2_Delay_Mix(float* Buf, float* DB, int num, float Dry, float Wet, float Len)
+{
+    const __m256 vDry = _mm256_set1_ps(Dry), vWet = _mm256_set1_ps(Wet), vLen = _mm256_set1_ps(Len), Half = _mm256_set1_ps(.5f);
+    int t = 0;
+    for (; t + 8 <= num; t += 8)
+    {
+        __m256 x = _mm256_loadu_ps(Buf + t);
+        __m256 d = _mm256_loadu_ps(DB + t);
+        _mm256_storeu_ps(Buf + t, _mm256_add_ps(_mm256_mul_ps(x, vDry), _mm256_mul_ps(d, vWet)));
+        _mm256_storeu_ps(DB + t, _mm256_add_ps(_mm256_mul_ps(Half, x), _mm256_mul_ps(d, vLen)));
+    }
+    MakoDSP::Delay_Mix(Buf + t, DB + t, num - t, Dry, Wet, Len);
+}
+
+//==============================================================================
+//R1.01 AVX-512. 16 floats at a time. Our segments are 32 samples so this is two steps. Mostly a win
+//R1.01 for the long delay runs. The biquad is the AVX2 one, a 4 stage pipe gains nothing from wider vectors.
+MAKO_TARGET("avx512f")
+static void AVX512_Gain_Ramp(const float* Src, float* Dest, int num, float Start, float Step)
+{
+    const __m512 vStart = _mm512_set1_ps(Start), vStep = _mm512_set1_ps(Step);
+    const __m512 One = _mm512_set_ps(16.0f, 15.0f, 14.0f, 13.0f, 12.0f, 11.0f, 10.0f, 9.0f, 8.0f, 7.0f, 6.0f, 5.0f, 4.0f, 3.0f, 2.0f, 1.0f);
+    int t = 0;
+    for (; t + 16 <= num; t += 16)
+    {
+        __m512 Vol = _mm512_add_ps(vStart, _mm512_mul_ps(vStep, _mm512_add_ps(One, _mm512_set1_ps(float(t)))));
+        _mm512_storeu_ps(Dest + t, _mm512_mul_ps(_mm512_loadu_ps(Src + t), Vol));
+    }
+    for (; t < num; t++) Dest[t] = Src[t] * (Start + Step * (t + 1));
+}
+
+MAKO_TARGET("avx512f")
+static void AVX512_Mix_Half(float* Dest, const float* Wet, int num, float Mix)
+{
+    float Dry = 1.0f - Mix;
+    const __m512 vDry = _mm512_set1_ps(Dry), vMix = _mm512_set1_ps(Mix), Half = _mm512_set1_ps(.5f);
+    int t = 0;
+    for (; t + 16 <= num; t += 16)
+    {
+        __m512 v = _mm512_add_ps(_mm512_mul_ps(_mm512_loadu_ps(Dest + t), vDry), _mm512_mul_ps(_mm512_loadu_ps(Wet + t), vMix));
+        _mm512_storeu_ps(Dest + t, _mm512_mul_ps(v, Half));
+    }
+    for (; t < num; t++) Dest[t] = ((Dest[t] * Dry) + (Wet[t] * Mix)) * .5f;
+}
+
+MAKO_TARGET("avx512f")
+static void AVX512_Scale(float* Dest, int num, float Gain)
+{
+    const __m512 vGain = _mm512_set1_ps(Gain);
+    int t = 0;
+    for (; t + 16 <= num; t += 16) _mm512_storeu_ps(Dest + t, _mm512_mul_ps(_mm512_loadu_ps(Dest + t), vGain));
+    for (; t < num; t++) Dest[t] *= Gain;
+}
+
+MAKO_TARGET("avx512f")
+static void AVX512_Copy(float* Dest, const float* Src, int num)
+{
+    int t = 0;
+    for (; t + 16 <= num; t += 16) _mm512_storeu_ps(Dest + t, _mm512_loadu_ps(Src + t));
+    for (; t < num; t++) Dest[t] = Src[t];
+}
+
+MAKO_TARGET("avx512f")
+static void AVX512_Delay_Mix(float* Buf, float* DB, int num, float Dry, float Wet, float Len)
+{
+    const __m512 vDry = _mm512_set1_ps(Dry), vWet = _mm512_set1_ps(Wet), vLen = _mm512_set1_ps(Len), Half = _mm512_set1_ps(.5f);
+    int t = 0;
+    for (; t + 16 <= num; t += 16)
+    {
+        __m512 x = _mm512_loadu_ps(Buf + t);
+        __m512 d = _mm512_loadu_ps(DB + t);
+        _mm512_storeu_ps(Buf + t, _mm512_add_ps(_mm512_mul_ps(x, vDry), _mm512_mul_ps(d, vWet)));
+        _mm512_storeu_ps(DB + t, _mm512_add_ps(_mm512_mul_ps(Half, x), _mm512_mul_ps(d, vLen)));
+    }
+    MakoDSP::Delay_Mix(Buf + t, DB + t, num - t, Dry, Wet, Len);
+}
+
+#endif
+
+//==============================================================================
+//R1.01 The kernel sets, lowest to highest. MAKO_ISA names match the Name field.
+enum { e_Kern_Generic, e_Kern_SSE2, e_Kern_AVX2, e_Kern_AVX512, e_Kern_Cnt };
+
+static const t_MakoKernels Kernel_Sets[] = {
+    { "generic", Gen_Biquad_Chain, MakoDSP::Gain_Ramp, Gen_Mix_Half, Gen_Scale, Gen_Copy, MakoDSP::Delay_Mix },
+   #if MAKO_X86
+    { "sse2", SSE2_Biquad_Chain, SSE2_Gain_Ramp, SSE2_Mix_Half, SSE2_Scale, SSE2_Copy, SSE2_Delay_Mix },
+    { "avx2", AVX2_Biquad_Chain, AVX2_Gain_Ramp, AVX2_Mix_Half, AVX2_Scale, AVX2_Copy, AVX2_Delay_Mix },
+    { "avx512", AVX2_Biquad_Chain, AVX512_Gain_Ramp, AVX512_Mix_Half, AVX512_Scale, AVX512_Copy, AVX512_Delay_Mix },
+   #endif
+};
+
+static const t_MakoKernels* Kernels_Choose()
+{
+    const int Sets = int(sizeof(Kernel_Sets) / sizeof(Kernel_Sets[0]));
+    int Best = e_Kern_Generic;
+
+   #if MAKO_X86
+    if (juce::SystemStats::hasSSE2()) Best = e_Kern_SSE2;
+    if ((Best == e_Kern_SSE2) && juce::SystemStats::hasAVX2() && juce::SystemStats::hasFMA3()) Best = e_Kern_AVX2;
+    if ((Best == e_Kern_AVX2) && juce::SystemStats::hasAVX512F()) Best = e_Kern_AVX512;
+   #endif
+
+    //R1.01 Testing override. Only ever moves down, a set the CPU can not run is never used.
+    juce::String Force = juce::SystemStats::getEnvironmentVariable("MAKO_ISA", {}).trim().toLowerCase();
+    for (int t = 0; t < Sets; t++)
+        if (Force == Kernel_Sets[t].Name) Best = juce::jmin(Best, t);
+
+    return &Kernel_Sets[Best];
+}
+
+const t_MakoKernels* MakoKernels_Select()
+{
+    //R1.01 C++ runs this once, thread safe, the first time any instance asks.
+    static const t_MakoKernels* Chosen = Kernels_Choose();
+    return Chosen;
+}
+
+const char* MakoKernels_Name()
+{
+    return MakoKernels_Select()->Name;
+}
@@ -0,0 +1,57 @@
+/*
+  ==============================================================================
+
+    MakoKernels.h
+    Block DSP kernels built for several instruction sets. The best set for
+    the CPU we are running on is picked once when the plugin loads.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//R1.01 KERNEL DISPATCH.
+//R1.01 The loops that run over a whole segment at once are kept here in a generic C++ version and in
+//R1.01 SSE2, AVX2 and AVX-512 versions. MakoKernels_Select checks the CPU and fills in a table of
+//R1.01 function pointers with the best versions it supports. Every instance uses that one table.
+//R1.01 Set MAKO_ISA to generic, sse2, avx2 or avx512 in the environment to force a lower set for testing.
+//R1.01 Except for Biquad_Chain in AVX2 and up (FMA), every version gives the same bits as generic.
+//R1.01 Check any change with Tools/MakoEquivalence.cpp.
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+ #define MAKO_X86 1
+#else
+ #define MAKO_X86 0
+#endif
+
+struct t_MakoKernels {
+    const char* Name;
+
+    //R1.01 Cascade of up to KERN_MaxStages biquads. Coef[s] = a0 a1 a2 b1 b2, Hist[s] = xn1 xn2 yn1 yn2.
+    void (*Biquad_Chain)(const float* Src, float* Dest, int num, const float (*Coef)[5], float (*Hist)[4], int Stages);
+
+    //R1.01 Dest[t] = Src[t] * (Start + Step * (t + 1)). Attack envelope.
+    void (*Gain_Ramp)(const float* Src, float* Dest, int num, float Start, float Step);
+
+    //R1.01 Dest[t] = ((Dest[t] * (1 - Mix)) + (Wet[t] * Mix)) * .5. Mix without the synth.
+    void (*Mix_Half)(float* Dest, const float* Wet, int num, float Mix);
+
+    //R1.01 Dest[t] *= Gain.
+    void (*Scale)(float* Dest, int num, float Gain);
+
+    //R1.01 Dest[t] = Src[t]. Mono copy.
+    void (*Copy)(float* Dest, const float* Src, int num);
+
+    //R1.01 Digital delay over a run of the delay buffer that does not wrap.
+    //R1.01 Out = x * Dry + DB * Wet, then DB = .5 * x + DB * Len. Buf is x in and Out out.
+    void (*Delay_Mix)(float* Buf, float* DB, int num, float Dry, float Wet, float Len);
+};
+
+static const int KERN_MaxStages = 8;
+
+//R1.01 Checks the CPU (and MAKO_ISA) the first time it is called. Same table every call after.
+const t_MakoKernels* MakoKernels_Select();
+
+//R1.01 Name of the chosen set (generic, sse2, avx2 or avx512). For tools and reports.
+const char* MakoKernels_Name();
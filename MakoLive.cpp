@@ -0,0 +1,365 @@
+/*
+  ==============================================================================
+
+    MakoLive.cpp
+    Low latency setup, loopback audio device and latency test for the
+    stand alone live box.
+
+  ==============================================================================
+*/
+
+#include "MakoLive.h"
+
+#if JUCE_LINUX || JUCE_MAC
+ #include <pthread.h>
+ #include <sched.h>
+ #include <sys/mman.h>
+ #include <cerrno>
+ #include <cstring>
+#endif
+
+bool MakoLive::Memory_Lock(juce::String& Error)
+{
+   #if JUCE_LINUX
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) == 0) return true;
+    Error = juce::String("mlockall failed: ") + strerror(errno) + ". Raise the memlock limit (ulimit -l unlimited).";
+    return false;
+   #else
+    Error = "Memory locking is only done on Linux.";
+    return false;
+   #endif
+}
+
+bool MakoLive::Thread_Realtime(int Priority)
+{
+   #if JUCE_LINUX || JUCE_MAC
+    sched_param Param;
+    Param.sched_priority = juce::jlimit(sched_get_priority_min(SCHED_FIFO), sched_get_priority_max(SCHED_FIFO), Priority);
+    return pthread_setschedparam(pthread_self(), SCHED_FIFO, &Param) == 0;
+   #else
+    juce::ignoreUnused(Priority);
+    return false;
+   #endif
+}
+
+int MakoLive::Buffer_Pick(juce::AudioIODevice& Device, int Wanted)
+{
+    auto Sizes = Device.getAvailableBufferSizes();
+    int Best = 0;
+    int Largest = Device.getDefaultBufferSize();
+    for (int Size : Sizes)
+    {
+        Largest = juce::jmax(Largest, Size);
+        if ((Wanted <= Size) && ((Best == 0) || (Size < Best))) Best = Size;
+    }
+    return (Best != 0) ? Best : Largest;
+}
+
+void MakoLiveCallback::audioDeviceIOCallbackWithContext(const float* const* Ins, int NumIns, float* const* Outs, int NumOuts,
+                                                        int num, const juce::AudioIODeviceCallbackContext& Context)
+{
+    juce::ignoreUnused(Ins, NumIns, Context);
+
+    //R1.01 Once per device start, on the audio thread itself. The setting stays with the thread.
+    if (!Started)
+    {
+        Started = true;
+        Realtime = MakoLive::Thread_Realtime(Priority) ? 1 : -1;
+        juce::FloatVectorOperations::disableDenormalisedNumberSupport(true);
+    }
+
+    //R1.01 The device manager adds every callback's output together. Ours adds silence.
+    for (int c = 0; c < NumOuts; c++)
+        if (Outs[c] != nullptr) juce::FloatVectorOperations::clear(Outs[c], num);
+}
+
+//==============================================================================
+MakoLoopbackDevice::MakoLoopbackDevice(int DelaySamples, bool PacedRun)
+    : juce::AudioIODevice("MonoTone Loopback", "Loopback"), juce::Thread("Mako Loopback"),
+      Delay(juce::jmax(0, DelaySamples)), Paced(PacedRun)
+{
+}
+
+MakoLoopbackDevice::~MakoLoopbackDevice()
+{
+    close();
+}
+
+juce::String MakoLoopbackDevice::open(const juce::BigInteger& Ins, const juce::BigInteger& Outs, double SampleRate, int BufferSize)
+{
+    juce::ignoreUnused(Ins, Outs);
+    close();
+
+    Rate = (0.0 < SampleRate) ? SampleRate : 48000.0;
+    Block = (0 < BufferSize) ? BufferSize : getDefaultBufferSize();
+    Active.clear();
+    Active.setRange(0, LOOP_Chans, true);
+
+    //R1.01 A card can not play back what it has not been given yet, so the loop is at least one buffer.
+    Delay = juce::jmax(Delay, Block);
+
+    int Size = juce::nextPowerOfTwo(Delay + Block + 1);
+    Ring_Mask = Size - 1;
+    Ring_Pos = 0;
+    for (int c = 0; c < LOOP_Chans; c++)
+    {
+        Ring[c].assign(size_t(Size), 0.0f);
+        In_B[c].assign(size_t(Block), 0.0f);
+        Out_B[c].assign(size_t(Block), 0.0f);
+    }
+
+    Opened = true;
+    return {};
+}
+
+void MakoLoopbackDevice::close()
+{
+    stop();
+    Opened = false;
+}
+
+void MakoLoopbackDevice::start(juce::AudioIODeviceCallback* Callback)
+{
+    if (!Opened || (Callback == nullptr)) return;
+    stop();
+
+    Callback->audioDeviceAboutToStart(this);
+    {
+        const juce::ScopedLock sl(CallbackLock);
+        Running = Callback;
+    }
+    startThread();
+}
+
+void MakoLoopbackDevice::stop()
+{
+    stopThread(2000);
+
+    juce::AudioIODeviceCallback* Old;
+    {
+        const juce::ScopedLock sl(CallbackLock);
+        Old = Running;
+        Running = nullptr;
+    }
+    if (Old != nullptr) Old->audioDeviceStopped();
+}
+
+void MakoLoopbackDevice::run()
+{
+    const float* Ins[LOOP_Chans];
+    float* Outs[LOOP_Chans];
+    for (int c = 0; c < LOOP_Chans; c++)
+    {
+        Ins[c] = In_B[c].data();
+        Outs[c] = Out_B[c].data();
+    }
+
+    double BlockMs = 1000.0 * Block / Rate;
+    double Next = juce::Time::getMillisecondCounterHiRes();
+
+    while (!threadShouldExit())
+    {
+        //R1.01 What was played Delay samples ago comes back in.
+        for (int c = 0; c < LOOP_Chans; c++)
+        {
+            for (int t = 0; t < Block; t++) In_B[c][size_t(t)] = Ring[c][size_t((Ring_Pos + t - Delay) & Ring_Mask)];
+            std::fill(Out_B[c].begin(), Out_B[c].end(), 0.0f);
+        }
+
+        {
+            const juce::ScopedLock sl(CallbackLock);
+            if (Running != nullptr) Running->audioDeviceIOCallbackWithContext(Ins, LOOP_Chans, Outs, LOOP_Chans, Block, {});
+        }
+
+        for (int c = 0; c < LOOP_Chans; c++)
+            for (int t = 0; t < Block; t++) Ring[c][size_t((Ring_Pos + t) & Ring_Mask)] = Out_B[c][size_t(t)];
+        Ring_Pos = (Ring_Pos + Block) & Ring_Mask;
+
+        //R1.01 Keep time like a sound card, or run flat out for tests.
+        if (Paced)
+        {
+            Next += BlockMs;
+            double Wait = Next - juce::Time::getMillisecondCounterHiRes();
+            if (1.0 <= Wait) wait(int(Wait));
+        }
+    }
+}
+
+//==============================================================================
+float MakoLatencyTest::Note_Freq(int n) const
+{
+    //R1.01 Open strings, low E to high E.
+    static const float Notes[LAT_Notes] = { 82.41f, 110.0f, 146.83f, 196.0f, 246.94f, 329.63f };
+    return Notes[n];
+}
+
+void MakoLatencyTest::audioDeviceAboutToStart(juce::AudioIODevice* Device)
+{
+    //R1.01 Not on the audio thread yet. Everything the test needs is made here.
+    Result = t_Result();
+    Result.Rate = Device->getCurrentSampleRate();
+    Result.Block = Device->getCurrentBufferSizeSamples();
+    Result.Notes = LAT_Notes;
+
+    Proc = std::make_unique<MakoBiteAudioProcessor>();
+    Proc->setPlayConfigDetails(2, 2, Result.Rate, Result.Block);
+    Proc->prepareToPlay(Result.Rate, Result.Block);
+    Result.Plugin_Latency = Proc->getLatencySamples();
+    Proc_B.setSize(2, juce::jmax(Result.Block, LAT_MaxBlock));
+
+    Stage = e_Lat_Clicks;
+    Pos = 0;
+    Base = 0;
+    Period = juce::int64(Result.Rate * .25);
+    Index = 0;
+    Sent = Arrived = Locked = -1;
+    Hold = 0;
+    Track_Sum = 0;
+    Done = false;
+}
+
+void MakoLatencyTest::Stage_Next(juce::int64 At)
+{
+    Stage++;
+    Base = At;
+    Index = 0;
+    Sent = Arrived = Locked = -1;
+    Hold = 0;
+    Phase = 0.0;
+
+    //R1.01 Notes ring for half a second with half a second of quiet after, so the tracker starts cold.
+    if (Stage == e_Lat_Notes) Period = juce::int64(Result.Rate);
+    if (Stage == e_Lat_Done) Finish();
+}
+
+void MakoLatencyTest::Finish()
+{
+    if (0 < Result.Clicks)
+    {
+        std::sort(Click_Delay, Click_Delay + Result.Clicks);
+        Result.RoundTrip = Click_Delay[Result.Clicks / 2];
+    }
+    if (0 < Result.Tracked) Result.Track_Avg = double(Track_Sum) / Result.Tracked;
+
+    if (Result.Clicks == 0)
+        Result.Error = "No clicks came back. Connect output 1 to input 1.";
+    else if (Result.Tracked == 0)
+        Result.Error = "The tracker did not lock on to any note.";
+    Result.Ok = Result.Error.isEmpty();
+    Done = true;
+}
+
+void MakoLatencyTest::audioDeviceIOCallbackWithContext(const float* const* Ins, int NumIns, float* const* Outs, int NumOuts,
+                                                       int num, const juce::AudioIODeviceCallbackContext& Context)
+{
+    juce::ignoreUnused(Context);
+    if (Proc_B.getNumSamples() < num) return;
+    const float* In = ((0 < NumIns) && (Ins[0] != nullptr)) ? Ins[0] : nullptr;
+    float* Out = ((0 < NumOuts) && (Outs[0] != nullptr)) ? Outs[0] : nullptr;
+    for (int c = 1; c < NumOuts; c++)
+        if (Outs[c] != nullptr) juce::FloatVectorOperations::clear(Outs[c], num);
+
+    //R1.01 Work in LAT_Step pieces so the tracker can be checked between them.
+    for (int s = 0; s < num; s += LAT_Step)
+    {
+        int n = juce::jmin(LAT_Step, num - s);
+
+        for (int t = s; t < s + n; t++)
+        {
+            juce::int64 Now = Pos + t;
+            float x = (In != nullptr) ? In[t] : 0.0f;
+            float y = 0.0f;
+
+            if (Stage == e_Lat_Clicks)
+            {
+                juce::int64 Start = Base + (Index + 1) * Period;
+                if ((Start <= Now) && (Now < Start + 4))
+                {
+                    y = .5f;
+                    Sent = Start;
+                }
+                if ((0 <= Sent) && (Arrived < 0) && (LAT_ClickThresh < fabsf(x)))
+                {
+                    Arrived = Now;
+                    Click_Delay[Result.Clicks++] = int(Now - Sent);
+                }
+                if (Now == Start + Period - 1)
+                {
+                    Index++;
+                    Sent = Arrived = -1;
+                    if (Index == LAT_Clicks) Stage_Next(Now + 1);
+                }
+            }
+            else if (Stage == e_Lat_Notes)
+            {
+                juce::int64 Start = Base + Index * Period;
+                juce::int64 Len = Period / 2;
+                if ((Start <= Now) && (Now < Start + Len))
+                {
+                    double Fade = juce::jmin(1.0, double(Now - Start) / (Result.Rate * .002));
+                    y = float(.5 * Fade * sin(Phase));
+                    Phase += juce::MathConstants<double>::twoPi * Note_Freq(Index) / Result.Rate;
+                    Sent = Start;
+                }
+                if ((0 <= Sent) && (Arrived < 0) && (LAT_NoteThresh < fabsf(x))) Arrived = Now;
+                if (Now == Start + Period - 1)
+                {
+                    Index++;
+                    Sent = Arrived = Locked = -1;
+                    Hold = 0;
+                    Phase = 0.0;
+                    if (Index == LAT_Notes) Stage_Next(Now + 1);
+                }
+            }
+
+            if (Out != nullptr) Out[t] = y;
+            Proc_B.setSample(0, t, x);
+            Proc_B.setSample(1, t, x);
+        }
+
+        //R1.01 What came in goes through the plugin. Then see if the tracker is on this note's pitch yet.
+        if (Stage == e_Lat_Notes)
+        {
+            juce::AudioBuffer<float> Piece(Proc_B.getArrayOfWritePointers(), 2, s, n);
+            Midi.clear();
+            Proc->processBlock(Piece, Midi);
+
+            if ((0 <= Arrived) && (Hold < LAT_Hold))
+            {
+                float f = Proc->Track_Freq(0);
+                bool On = (0.0f < f) && (fabsf(1200.0f * log2f(f / Note_Freq(Index))) < Cents);
+                if (!On)
+                    Hold = 0;
+                else if (Hold++ == 0)
+                    Locked = Pos + s + n;
+
+                if (Hold == LAT_Hold)
+                {
+                    Track_Sum += Locked - Arrived;
+                    Result.Track_Max = juce::jmax(Result.Track_Max, int(Locked - Arrived));
+                    Result.Tracked++;
+                }
+            }
+        }
+    }
+
+    Pos += num;
+}
+
+MakoLatencyTest::t_Result MakoLatency_Run(juce::AudioDeviceManager& Devices, int TimeoutMs)
+{
+    MakoLatencyTest Test;
+    Devices.addAudioCallback(&Test);
+
+    double Start = juce::Time::getMillisecondCounterHiRes();
+    while (!Test.Finished() && (juce::Time::getMillisecondCounterHiRes() - Start < TimeoutMs)) juce::Thread::sleep(10);
+    Devices.removeAudioCallback(&Test);
+
+    if (!Test.Finished())
+    {
+        MakoLatencyTest::t_Result R;
+        R.Error = "Timed out. Is an audio device open and output 1 connected to input 1?";
+        return R;
+    }
+    return Test.Result_Get();
+}
@@ -0,0 +1,183 @@
+/*
+  ==============================================================================
+
+    MakoLive.h
+    Running MonoTone as a stand alone live box. Low latency setup for the
+    audio thread, a loopback audio device for headless machines, and the
+    round trip / pitch tracking latency test.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "PluginProcessor.h"
+
+//R1.01 LIVE MODE.
+//R1.01 Used by the custom stand alone app (MakoStandalone.cpp) when started with --live.
+//R1.01 Memory is locked before audio starts so nothing the audio thread touches can be paged out.
+//R1.01 MakoLiveCallback runs on the audio thread just before the plugin. The first time it is called
+//R1.01 after a device starts it raises that thread to real time priority and turns off denormals.
+namespace MakoLive
+{
+    //R1.01 Lock all current and future memory in RAM. Linux needs RLIMIT_MEMLOCK (ulimit -l) or CAP_IPC_LOCK.
+    bool Memory_Lock(juce::String& Error);
+
+    //R1.01 SCHED_FIFO at this priority (1 - 99) for the calling thread. Linux needs rtprio in limits.conf.
+    bool Thread_Realtime(int Priority);
+
+    //R1.01 Smallest buffer size the device can do that is at least Wanted. Its largest if none are.
+    int Buffer_Pick(juce::AudioIODevice& Device, int Wanted);
+}
+
+class MakoLiveCallback : public juce::AudioIODeviceCallback
+{
+public:
+    explicit MakoLiveCallback(int RtPriority) : Priority(RtPriority) {}
+
+    //R1.01 1 = real time priority set, -1 = it was refused, 0 = audio has not started yet.
+    int Realtime_Get() const { return Realtime.load(); }
+
+    void audioDeviceAboutToStart(juce::AudioIODevice*) override { Started = false; }
+    void audioDeviceStopped() override {}
+    void audioDeviceIOCallbackWithContext(const float* const* Ins, int NumIns, float* const* Outs, int NumOuts,
+                                          int num, const juce::AudioIODeviceCallbackContext& Context) override;
+
+private:
+    int Priority;
+    bool Started = false;
+    std::atomic<int> Realtime { 0 };
+};
+
+//R1.01 LOOPBACK DEVICE.
+//R1.01 A fake audio device. A thread calls back every buffer like a sound card, and whatever was played
+//R1.01 comes back on the inputs Delay samples later, the way a cable from output to input would.
+//R1.01 With Paced off it runs as fast as it can, so the latency test finishes quickly on a build server.
+class MakoLoopbackDevice : public juce::AudioIODevice, private juce::Thread
+{
+public:
+    MakoLoopbackDevice(int DelaySamples, bool Paced);
+    ~MakoLoopbackDevice() override;
+
+    juce::StringArray getOutputChannelNames() override { return { "Loop 1", "Loop 2" }; }
+    juce::StringArray getInputChannelNames() override { return { "Loop 1", "Loop 2" }; }
+    juce::Array<double> getAvailableSampleRates() override { return { 44100.0, 48000.0, 88200.0, 96000.0, 192000.0 }; }
+    juce::Array<int> getAvailableBufferSizes() override { return { 16, 32, 64, 128, 256, 512, 1024 }; }
+    int getDefaultBufferSize() override { return 64; }
+
+    juce::String open(const juce::BigInteger& Ins, const juce::BigInteger& Outs, double SampleRate, int BufferSize) override;
+    void close() override;
+    bool isOpen() override { return Opened; }
+    void start(juce::AudioIODeviceCallback* Callback) override;
+    void stop() override;
+    bool isPlaying() override { return Running != nullptr; }
+    juce::String getLastError() override { return {}; }
+
+    int getCurrentBufferSizeSamples() override { return Block; }
+    double getCurrentSampleRate() override { return Rate; }
+    int getCurrentBitDepth() override { return 32; }
+    juce::BigInteger getActiveOutputChannels() const override { return Active; }
+    juce::BigInteger getActiveInputChannels() const override { return Active; }
+    int getOutputLatencyInSamples() override { return Delay / 2; }
+    int getInputLatencyInSamples() override { return Delay - Delay / 2; }
+
+private:
+    static const int LOOP_Chans = 2;
+
+    int Delay;
+    bool Paced;
+    bool Opened = false;
+    double Rate = 48000.0;
+    int Block = 64;
+    juce::BigInteger Active;
+
+    juce::CriticalSection CallbackLock;
+    juce::AudioIODeviceCallback* Running = nullptr;
+
+    //R1.01 One ring per channel. Output is written at Ring_Pos, input is read Delay samples behind it.
+    std::vector<float> Ring[LOOP_Chans];
+    int Ring_Mask = 0;
+    int Ring_Pos = 0;
+    std::vector<float> In_B[LOOP_Chans], Out_B[LOOP_Chans];
+
+    void run() override;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MakoLoopbackDevice)
+};
+
+//R1.01 LATENCY TEST.
+//R1.01 Runs as the device callback with a cable (or the loopback device) from output 1 to input 1.
+//R1.01   Round trip: short clicks are played and timed until they come back in. This is the delay of the
+//R1.01               sound card, driver and buffers, what a player hears on top of the plugin.
+//R1.01   Tracking:   tone bursts at guitar pitches are played, and what comes back in goes through its own
+//R1.01               MonoTone. Timed from when the note arrives at the input to when the tracker holds the
+//R1.01               right pitch (within Cents). This includes the plugin's own latency (resampling).
+class MakoLatencyTest : public juce::AudioIODeviceCallback
+{
+public:
+    struct t_Result {
+        bool Ok = false;
+        juce::String Error;
+        double Rate = 0.0;
+        int Block = 0;
+        int RoundTrip = 0;          //R1.01 Samples, median of the clicks that came back.
+        int Clicks = 0;             //R1.01 Clicks that came back.
+        double Track_Avg = 0.0;     //R1.01 Samples.
+        int Track_Max = 0;
+        int Tracked = 0;            //R1.01 Notes the tracker locked on to.
+        int Notes = 0;
+        int Plugin_Latency = 0;     //R1.01 What the plugin reports to hosts. Part of Track.
+    };
+
+    explicit MakoLatencyTest(float CentsLimit = 25.0f) : Cents(CentsLimit) {}
+
+    bool Finished() const { return Done.load(); }
+    t_Result Result_Get() const { return Result; }   //R1.01 Only after Finished.
+
+    void audioDeviceAboutToStart(juce::AudioIODevice* Device) override;
+    void audioDeviceStopped() override {}
+    void audioDeviceIOCallbackWithContext(const float* const* Ins, int NumIns, float* const* Outs, int NumOuts,
+                                          int num, const juce::AudioIODeviceCallbackContext& Context) override;
+
+private:
+    static const int LAT_Clicks = 8;
+    static const int LAT_Notes = 6;
+    static const int LAT_Step = 32;                 //R1.01 Tracker is checked this often. Same as the plugin segment.
+    static const int LAT_MaxBlock = 8192;           //R1.01 Largest callback the test handles, whatever the device says.
+    static const int LAT_Hold = 8;                  //R1.01 Checks in a row on pitch before a note counts as tracked.
+    static constexpr float LAT_ClickThresh = .1f;
+    static constexpr float LAT_NoteThresh = .02f;
+
+    enum { e_Lat_Clicks, e_Lat_Notes, e_Lat_Done };
+
+    float Cents;
+    int Stage = e_Lat_Clicks;
+    juce::int64 Pos = 0;            //R1.01 Samples since the device started.
+    juce::int64 Base = 0;           //R1.01 When this stage started.
+    juce::int64 Period = 0;         //R1.01 Samples between clicks or notes.
+    int Index = 0;                  //R1.01 Click or note being timed.
+    juce::int64 Sent = -1;          //R1.01 When it was played. -1 = not yet.
+    juce::int64 Arrived = -1;       //R1.01 When it came back in. -1 = not yet.
+    juce::int64 Locked = -1;        //R1.01 First on pitch check of the current hold run.
+    int Hold = 0;
+    double Phase = 0.0;
+
+    int Click_Delay[LAT_Clicks] = {};
+    juce::int64 Track_Sum = 0;
+
+    std::unique_ptr<MakoBiteAudioProcessor> Proc;
+    juce::AudioBuffer<float> Proc_B;
+    juce::MidiBuffer Midi;
+
+    t_Result Result;
+    std::atomic<bool> Done { false };
+
+    void Stage_Next(juce::int64 At);
+    void Finish();
+    float Note_Freq(int n) const;
+};
+
+//R1.01 Runs the test on a device manager that is already set up, waits for it and returns the result.
+//R1.01 Called from the message thread. TimeoutMs guards against an unplugged cable.
+MakoLatencyTest::t_Result MakoLatency_Run(juce::AudioDeviceManager& Devices, int TimeoutMs);
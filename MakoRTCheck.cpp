@@ -0,0 +1,179 @@
+/*
+  ==============================================================================
+
+    MakoRTCheck.cpp
+    Real time safety checks for the audio thread.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "MakoRTCheck.h"
+
+#if MAKO_RTCHECK
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+//R1.01 One flag per thread. Only the audio thread ever sets it.
+static thread_local bool RT_InCallback = false;
+
+bool MakoRTCheck::InAudioCallback() noexcept
+{
+    return RT_InCallback;
+}
+
+void MakoRTCheck::Violation(const char* What)
+{
+    //R1.01 Clear the flag first. Printing the stack trace allocates.
+    RT_InCallback = false;
+
+    std::fprintf(stderr, "\n*** MAKO RTCHECK: %s on the audio thread ***\n", What);
+    std::fputs(juce::SystemStats::getStackBacktrace().toRawUTF8(), stderr);
+    std::fflush(stderr);
+
+    //R1.01 Fail the run so it can not be missed.
+    std::abort();
+}
+
+MakoRTCheck::ScopedAudioCallback::ScopedAudioCallback() noexcept : WasIn(RT_InCallback)
+{
+    RT_InCallback = true;
+}
+
+MakoRTCheck::ScopedAudioCallback::~ScopedAudioCallback() noexcept
+{
+    RT_InCallback = WasIn;
+}
+
+MakoRTCheck::ScopedAllow::ScopedAllow() noexcept : WasIn(RT_InCallback)
+{
+    RT_InCallback = false;
+}
+
+MakoRTCheck::ScopedAllow::~ScopedAllow() noexcept
+{
+    RT_InCallback = WasIn;
+}
+
+//==============================================================================
+//R1.01 Replace the global operator new/delete so every C++ allocation is checked.
+//R1.01 On Windows this covers everything in the plugin DLL. On Linux/Mac a plugin module must
+//R1.01 be linked with -Bsymbolic (or run inside our own tools) so its calls bind to these.
+static void* RT_Alloc(std::size_t Size, const char* What)
+{
+    if (RT_InCallback) MakoRTCheck::Violation(What);
+
+    void* p = std::malloc(Size == 0 ? 1 : Size);
+    if (p == nullptr) throw std::bad_alloc();
+    return p;
+}
+
+static void RT_Free(void* p, const char* What)
+{
+    if ((p != nullptr) && RT_InCallback) MakoRTCheck::Violation(What);
+    std::free(p);
+}
+
+void* operator new (std::size_t Size)                                   { return RT_Alloc(Size, "operator new"); }
+void* operator new[] (std::size_t Size)                                 { return RT_Alloc(Size, "operator new[]"); }
+void* operator new (std::size_t Size, const std::nothrow_t&) noexcept   { if (RT_InCallback) MakoRTCheck::Violation("operator new"); return std::malloc(Size == 0 ? 1 : Size); }
+void* operator new[] (std::size_t Size, const std::nothrow_t&) noexcept { if (RT_InCallback) MakoRTCheck::Violation("operator new[]"); return std::malloc(Size == 0 ? 1 : Size); }
+
+void operator delete (void* p) noexcept                                 { RT_Free(p, "operator delete"); }
+void operator delete[] (void* p) noexcept                               { RT_Free(p, "operator delete[]"); }
+void operator delete (void* p, std::size_t) noexcept                    { RT_Free(p, "operator delete"); }
+void operator delete[] (void* p, std::size_t) noexcept                  { RT_Free(p, "operator delete[]"); }
+void operator delete (void* p, const std::nothrow_t&) noexcept          { RT_Free(p, "operator delete"); }
+void operator delete[] (void* p, const std::nothrow_t&) noexcept        { RT_Free(p, "operator delete[]"); }
+
+//R1.01 Over aligned types (alignas bigger than the default) use these instead. Aligned blocks must
+//R1.01 be freed by the matching call, so they can not share RT_Alloc/RT_Free on Windows.
+#if __cpp_aligned_new
+static void* RT_AllocAligned(std::size_t Size, std::align_val_t Align, const char* What) noexcept
+{
+    if (RT_InCallback) MakoRTCheck::Violation(What);
+
+    std::size_t A = juce::jmax(std::size_t(Align), sizeof(void*));
+   #if JUCE_WINDOWS
+    return _aligned_malloc(Size == 0 ? 1 : Size, A);
+   #else
+    void* p = nullptr;
+    if (posix_memalign(&p, A, Size == 0 ? 1 : Size) != 0) return nullptr;
+    return p;
+   #endif
+}
+
+static void RT_FreeAligned(void* p, const char* What) noexcept
+{
+    if ((p != nullptr) && RT_InCallback) MakoRTCheck::Violation(What);
+   #if JUCE_WINDOWS
+    _aligned_free(p);
+   #else
+    std::free(p);
+   #endif
+}
+
+static void* RT_AllocAlignedOrThrow(std::size_t Size, std::align_val_t Align, const char* What)
+{
+    void* p = RT_AllocAligned(Size, Align, What);
+    if (p == nullptr) throw std::bad_alloc();
+    return p;
+}
+
+void* operator new (std::size_t Size, std::align_val_t Align)                                   { return RT_AllocAlignedOrThrow(Size, Align, "operator new"); }
+void* operator new[] (std::size_t Size, std::align_val_t Align)                                 { return RT_AllocAlignedOrThrow(Size, Align, "operator new[]"); }
+void* operator new (std::size_t Size, std::align_val_t Align, const std::nothrow_t&) noexcept   { return RT_AllocAligned(Size, Align, "operator new"); }
+void* operator new[] (std::size_t Size, std::align_val_t Align, const std::nothrow_t&) noexcept { return RT_AllocAligned(Size, Align, "operator new[]"); }
+
+void operator delete (void* p, std::align_val_t) noexcept                                       { RT_FreeAligned(p, "operator delete"); }
+void operator delete[] (void* p, std::align_val_t) noexcept                                     { RT_FreeAligned(p, "operator delete[]"); }
+void operator delete (void* p, std::size_t, std::align_val_t) noexcept                          { RT_FreeAligned(p, "operator delete"); }
+void operator delete[] (void* p, std::size_t, std::align_val_t) noexcept                        { RT_FreeAligned(p, "operator delete[]"); }
+void operator delete (void* p, std::align_val_t, const std::nothrow_t&) noexcept                { RT_FreeAligned(p, "operator delete"); }
+void operator delete[] (void* p, std::align_val_t, const std::nothrow_t&) noexcept              { RT_FreeAligned(p, "operator delete[]"); }
+#endif
+
+//==============================================================================
+//R1.01 glibc: also catch malloc/free called directly (juce::HeapBlock, C libraries).
+#if JUCE_LINUX && defined (__GLIBC__)
+extern "C"
+{
+    void* __libc_malloc (size_t);
+    void* __libc_calloc (size_t, size_t);
+    void* __libc_realloc (void*, size_t);
+    void __libc_free (void*);
+
+    void* malloc (size_t Size)              { if (RT_InCallback) MakoRTCheck::Violation("malloc"); return __libc_malloc(Size); }
+    void* calloc (size_t Num, size_t Size)  { if (RT_InCallback) MakoRTCheck::Violation("calloc"); return __libc_calloc(Num, Size); }
+    void* realloc (void* p, size_t Size)    { if (RT_InCallback) MakoRTCheck::Violation("realloc"); return __libc_realloc(p, Size); }
+    void free (void* p)                     { if ((p != nullptr) && RT_InCallback) MakoRTCheck::Violation("free"); __libc_free(p); }
+}
+
+//R1.01 Also catch locks. juce::CriticalSection, std::mutex and most C libraries end up here.
+//R1.01 Try locks never wait, so pthread_mutex_trylock is left alone. glibc only exports the real
+//R1.01 function under this name, so it is looked up once with dlsym. The first lock happens during
+//R1.01 startup, long before any audio runs.
+#include <dlfcn.h>
+#include <pthread.h>
+#include <atomic>
+
+typedef int (*t_MutexLock)(pthread_mutex_t*);
+static std::atomic<t_MutexLock> RT_MutexLock { nullptr };
+
+extern "C" int pthread_mutex_lock (pthread_mutex_t* m)
+{
+    if (RT_InCallback) MakoRTCheck::Violation("pthread_mutex_lock");
+
+    t_MutexLock Lock = RT_MutexLock.load(std::memory_order_relaxed);
+    if (Lock == nullptr)
+    {
+        Lock = (t_MutexLock) dlsym(RTLD_NEXT, "pthread_mutex_lock");
+        RT_MutexLock.store(Lock, std::memory_order_relaxed);
+    }
+    return Lock(m);
+}
+#endif
+
+#endif
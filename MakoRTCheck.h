@@ -0,0 +1,58 @@
+/*
+  ==============================================================================
+
+    MakoRTCheck.h
+    Real time safety checks for the audio thread.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+//R1.01 REAL TIME SAFETY CHECK.
+//R1.01 Build with MAKO_RTCHECK=1 (Projucer preprocessor definitions) to turn it on. When on, every
+//R1.01 heap allocation or free made while processBlock is running prints a stack trace and stops
+//R1.01 the program. This catches code that would glitch on a live rig before it gets there.
+//R1.01 When off, everything here compiles to nothing.
+#ifndef MAKO_RTCHECK
+ #define MAKO_RTCHECK 0
+#endif
+
+#if MAKO_RTCHECK
+
+namespace MakoRTCheck
+{
+    //R1.01 True while this thread is inside processBlock.
+    bool InAudioCallback() noexcept;
+
+    //R1.01 Report a real time violation. What = short description ("operator new", "free", ...).
+    void Violation(const char* What);
+
+    //R1.01 Sets the in audio callback flag for the life of the object.
+    struct ScopedAudioCallback
+    {
+        ScopedAudioCallback() noexcept;
+        ~ScopedAudioCallback() noexcept;
+        bool WasIn;
+    };
+
+    //R1.01 Lets a block of code allocate on purpose, e.g. a test harness filling a buffer.
+    struct ScopedAllow
+    {
+        ScopedAllow() noexcept;
+        ~ScopedAllow() noexcept;
+        bool WasIn;
+    };
+}
+
+ #define MAKO_RTCHECK_AUDIO_SCOPE  MakoRTCheck::ScopedAudioCallback makoRTCheckScope
+ #define MAKO_RTCHECK_ALLOW_SCOPE  MakoRTCheck::ScopedAllow makoRTCheckAllow
+ #define MAKO_RTCHECK_BLOCKING(what)  if (MakoRTCheck::InAudioCallback()) MakoRTCheck::Violation(what)
+
+#else
+
+ #define MAKO_RTCHECK_AUDIO_SCOPE
+ #define MAKO_RTCHECK_ALLOW_SCOPE
+ #define MAKO_RTCHECK_BLOCKING(what)
+
+#endif
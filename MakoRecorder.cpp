@@ -0,0 +1,103 @@
+/*
+  ==============================================================================
+
+    MakoRecorder.cpp
+    Captures the audio and parameter changes going into processBlock so a
+    session can be replayed exactly, offline.
+
+  ==============================================================================
+*/
+
+#include "MakoRecorder.h"
+
+MakoRecorder::MakoRecorder() : juce::Thread("Mako Recorder")
+{
+}
+
+MakoRecorder::~MakoRecorder()
+{
+    Stop();
+}
+
+bool MakoRecorder::Start(const juce::File& CaptureFile)
+{
+    //R1.01 Only called while audio is stopped (prepareToPlay), so nothing is writing to the FIFO.
+    Stop();
+
+    CaptureFile.deleteFile();
+    Stream = std::make_unique<juce::FileOutputStream>(CaptureFile);
+    if (!Stream->openedOk())
+    {
+        Stream.reset();
+        return false;
+    }
+
+    if (Fifo_Data == nullptr) Fifo_Data.malloc(FIFO_Size);
+    Fifo.reset();
+    Lost.store(false);
+    Active.store(true);
+    startThread();
+    return true;
+}
+
+void MakoRecorder::Stop()
+{
+    //R1.01 Audio must be stopped. Write whatever is left and close the file with an end record.
+    if (Stream == nullptr) return;
+
+    Active.store(false);
+    stopThread(2000);
+    Fifo_Drain();
+
+    t_RecEnd End = { e_Rec_End, Lost.load() ? 1 : 0 };
+    Stream->write(&End, sizeof(End));
+    Stream->flush();
+    Stream.reset();
+}
+
+bool MakoRecorder::Record_Begin(int Bytes)
+{
+    if (!Active.load()) return false;
+
+    //R1.01 A record that does not fit would leave a hole in the capture. Stop here instead.
+    if (Fifo.getFreeSpace() < Bytes)
+    {
+        Lost.store(true);
+        Active.store(false);
+        return false;
+    }
+    return true;
+}
+
+void MakoRecorder::Record_Write(const void* Data, int Bytes)
+{
+    int Start1, Size1, Start2, Size2;
+    Fifo.prepareToWrite(Bytes, Start1, Size1, Start2, Size2);
+
+    const char* Src = static_cast<const char*>(Data);
+    if (0 < Size1) memcpy(Fifo_Data + Start1, Src, size_t(Size1));
+    if (0 < Size2) memcpy(Fifo_Data + Start2, Src + Size1, size_t(Size2));
+
+    Fifo.finishedWrite(Size1 + Size2);
+}
+
+//R1.01 Writer thread only (or Stop once the thread has ended).
+void MakoRecorder::Fifo_Drain()
+{
+    int Start1, Size1, Start2, Size2;
+    Fifo.prepareToRead(Fifo.getNumReady(), Start1, Size1, Start2, Size2);
+
+    if (0 < Size1) Stream->write(Fifo_Data + Start1, size_t(Size1));
+    if (0 < Size2) Stream->write(Fifo_Data + Start2, size_t(Size2));
+
+    Fifo.finishedRead(Size1 + Size2);
+}
+
+void MakoRecorder::run()
+{
+    while (!threadShouldExit())
+    {
+        wait(20);
+        Fifo_Drain();
+    }
+}
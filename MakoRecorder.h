@@ -0,0 +1,105 @@
+/*
+  ==============================================================================
+
+    MakoRecorder.h
+    Captures the audio and parameter changes going into processBlock so a
+    session can be replayed exactly, offline.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//R1.01 CAPTURE FILE FORMAT.
+//R1.01 A capture file is a list of records written in native byte order. Each record starts with an int32 type.
+//R1.01   t_RecHeader   once, from prepareToPlay. Followed by float Setting[ParmCnt] and float Delay_Ratio[ChanCnt].
+//R1.01   t_RecBlock    once per processBlock call. Followed by float Setting[ParmCnt], t_RecEvent[EventCnt]
+//R1.01                 and the input audio, NumChannels x NumSamples floats, one channel after the other.
+//R1.01                 An event Idx of ParmCnt + n is a new delay ratio for channel n. ForceAll = 1 if the block
+//R1.01                 starts with a full settings update (a state load). GovLevel is the quality
+//R1.01                 governor level the block ran at, so a replay makes the same trade offs the session did.
+//R1.01   t_RecEnd      when recording stops. Lost = 1 if the capture overflowed and is not complete.
+struct t_RecHeader {
+    juce::int32 Type;
+    juce::uint32 Magic;
+    juce::int32 Version;
+    juce::int32 MaxBlock;
+    double SampleRate;
+    juce::int32 NumIn;
+    juce::int32 NumOut;
+    juce::int32 Mono;
+    juce::int32 Midi;
+    juce::int32 BypassOn;
+    juce::int32 ParmCnt;
+    juce::int32 ChanCnt;
+    juce::int32 Pad;
+};
+
+struct t_RecBlock {
+    juce::int32 Type;
+    juce::int32 NumSamples;
+    juce::int32 NumChannels;
+    juce::int32 Mono;
+    juce::int32 Midi;
+    juce::int32 SettingsChanged;
+    juce::int32 EventCnt;
+    juce::int32 ForceAll;
+    juce::int32 GovLevel;
+};
+
+struct t_RecEvent {
+    juce::int32 Offset;
+    juce::int32 Idx;
+    float Value;
+};
+
+struct t_RecEnd {
+    juce::int32 Type;
+    juce::int32 Lost;
+};
+
+static_assert(sizeof(t_RecHeader) == 56, "t_RecHeader layout changed");
+static_assert(sizeof(t_RecBlock) == 36, "t_RecBlock layout changed");
+static_assert(sizeof(t_RecEvent) == 12, "t_RecEvent layout changed");
+
+//R1.01 Streams records from the audio thread to a capture file. The audio thread only copies into a
+//R1.01 lock free FIFO. A background thread writes the FIFO to disk. If the disk can not keep up the
+//R1.01 capture is marked as lost and stops, the audio thread is never held up.
+class MakoRecorder : public juce::Thread
+{
+public:
+    static const juce::uint32 REC_Magic = 0x31524B4D;   //R1.01 "MKR1"
+    static const int REC_Version = 3;
+    enum { e_Rec_Header = 1, e_Rec_Block, e_Rec_Bypassed, e_Rec_End };
+
+    MakoRecorder();
+    ~MakoRecorder() override;
+
+    //R1.01 Not on the audio thread. Opens the capture file and starts the writer thread.
+    bool Start(const juce::File& CaptureFile);
+    void Stop();
+
+    bool IsActive() const { return Active.load(); }
+
+    //R1.01 Audio thread. Returns false if there is no room. The record is then dropped and the capture marked lost.
+    bool Record_Begin(int Bytes);
+    void Record_Write(const void* Data, int Bytes);
+
+    void run() override;
+
+private:
+    static const int FIFO_Size = 8 * 1024 * 1024;     //R1.01 About 20 seconds of stereo 48 kHz audio.
+
+    juce::HeapBlock<char> Fifo_Data;
+    juce::AbstractFifo Fifo { FIFO_Size };
+    std::unique_ptr<juce::FileOutputStream> Stream;
+
+    std::atomic<bool> Active { false };
+    std::atomic<bool> Lost { false };
+
+    void Fifo_Drain();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MakoRecorder)
+};
@@ -0,0 +1,267 @@
+/*
+  ==============================================================================
+
+    MakoReference.cpp
+    Frozen scalar reference model of our DSP kernels. Only built into
+    MAKO_REFERENCE_CHECK builds, where Tools/MakoEquivalence.cpp runs it side
+    by side with the optimized kernels.
+
+  ==============================================================================
+*/
+
+#include "PluginProcessor.h"
+
+#if MAKO_REFERENCE_CHECK
+
+//R1.01 REFERENCE MODEL.
+//R1.01 The original scalar code (R1.00 Mako_FX_MonoToneSyn and friends), one sample and one filter at a time.
+//R1.01 SINF for every oscillator, its own phase, its own Boost and mix. It shares no kernel with the code it checks,
+//R1.01 only the per channel state and the coefficients. Where the plugin changed the sound on purpose (rate
+//R1.01 independent envelopes, segment rate attack, band limited squares, Boost makeup) the change is written out
+//R1.01 again here from scratch. When PluginProcessor.cpp is made faster, these stay as they are so it can be measured.
+
+//R1.00 Actual filter calculation code that modifies our sample.
+float MakoBiteAudioProcessor::Ref_Calc_BiQuad(float tSample, tp_filterhist* hist, const tp_filter* fn)
+{
+    float tS = fn->a0 * tSample + fn->a1 * hist->xn1 + fn->a2 * hist->xn2 - fn->b1 * hist->yn1 - fn->b2 * hist->yn2;
+    hist->xn2 = hist->xn1; hist->xn1 = tSample; hist->yn2 = hist->yn1; hist->yn1 = tS;
+
+    return tS;
+}
+
+//R1.01 The pitch analysis chain, one biquad call per stage per sample.
+void MakoBiteAudioProcessor::Ref_Analysis_Block(const float* Src, float* Dest, int num, int channel)
+{
+    tp_chanstate& cs = Chan_State[channel];
+
+    for (int t = 0; t < num; t++)
+    {
+        float tS = Ref_Calc_BiQuad(Src[t], &cs.Filt[FILT_LoCut], &makoF_LoCut);
+        for (int st = 0; st < ANALYSIS_LPStages; st++) tS = Ref_Calc_BiQuad(tS, &cs.Filt[FILT_HiCut + st], &makoF_HiCut[st]);
+        if (ANALYSIS_Emphasis) tS = Ref_Calc_BiQuad(tS, &cs.Filt[FILT_Emph], &makoF_Emph);
+        Dest[t] = tS;
+    }
+}
+
+//R1.01 One channel of one segment the way the original code ran it, a sample at a time through attack,
+//R1.01 synth, boost, mix, delay and gain. Nothing from MakoKernels and nothing from PluginProcessor.h's oscillators.
+void MakoBiteAudioProcessor::Ref_Segment(float* channelData, int start, int num, int channel, bool AttackOn, bool TrackOn, bool SynthOn)
+{
+    float Attacked[SEGMENT_Size];
+    float Analysis[SEGMENT_Size];
+    float Synth[SEGMENT_Size];
+    float* Buf = channelData + start;
+
+    for (int t = 0; t < num; t++) Attacked[t] = Buf[t];
+    if (AttackOn) Ref_FX_Attack(Attacked, num, channel);
+
+    for (int t = 0; t < num; t++) Synth[t] = Attacked[t];
+    if (TrackOn)
+    {
+        Ref_Analysis_Block(Attacked, Analysis, num, channel);
+        for (int t = 0; t < num; t++)
+        {
+            Midi_Offset = Midi_HostOffset(start + t);
+            Synth[t] = Ref_FX_MonoToneSyn(Attacked[t], Analysis[t], channel);
+        }
+        if (SynthOn) Ref_FX_Boost(Synth, num, channel);
+    }
+
+    //R1.00 Mix original sample and new modified synth sample. Halved so 1 + 1 does not clip.
+    float Mix = (.001f <= Setting[e_Mix]) ? Setting[e_Mix] : 0.0f;
+    for (int t = 0; t < num; t++)
+    {
+        float tS = ((Buf[t] * (1.0f - Mix)) + (Synth[t] * Mix)) * .5f;
+        Buf[t] = Ref_FX_Delay(tS, channel) * Setting[e_Gain];
+    }
+}
+
+//R1.00 ATTACK.
+//R1.01 Segment rate envelope like the plugin (that was a planned change), ramped with plain scalar math.
+void MakoBiteAudioProcessor::Ref_FX_Attack(float* Buf, int num, int channel)
+{
+    tp_chanstate& cs = Chan_State[channel];
+    if (Setting[e_Attack] < .001f) return;
+
+    float SumAbs = 0.0f;
+    float MaxSample = 0.0f;
+    for (int t = 0; t < num; t++)
+    {
+        SumAbs += fabsf(Buf[t]);
+        if (MaxSample < Buf[t]) MaxSample = Buf[t];
+    }
+
+    float Blend = powf(Env_Avg.Coef, float(num));
+    cs.Signal_AVG = (cs.Signal_AVG * Blend) + ((SumAbs / num) * (1.0f - Blend));
+
+    if (!cs.Signal_VolFadeOn && (.001f < MaxSample))
+    {
+        cs.Signal_VolFadeOn = true;
+        cs.Signal_VolFade = 0.0f;
+    }
+    if (cs.Signal_AVG < .0001f) cs.Signal_VolFadeOn = false;
+
+    float VolStart = cs.Signal_VolFade;
+    float VolEnd;
+    if (.0005f < cs.Signal_AVG)
+        VolEnd = VolStart + (Attack_Inc * num);
+    else
+        VolEnd = VolStart * powf(Env_FadeOut.Coef, float(num));
+    if (.9999f < VolEnd) VolEnd = .9999f;
+    cs.Signal_VolFade = VolEnd;
+
+    float VolStep = (VolEnd - VolStart) / num;
+    for (int t = 0; t < num; t++) Buf[t] *= VolStart + VolStep * (t + 1);
+}
+
+//R1.01 Band limiting step for the reference squares. t is the position in the cycle, dt the cycles per sample.
+static float Ref_BLEP(double t, double dt)
+{
+    if (t < dt)
+    {
+        t /= dt;
+        return float(t + t - t * t - 1.0);
+    }
+    if ((1.0 - dt) < t)
+    {
+        t = (t - 1.0) / dt;
+        return float(t * t + t + t + 1.0);
+    }
+    return 0.0f;
+}
+
+//R1.01 Square from the sign of SINF like the original, plus the band limiting the plugin added on purpose.
+static float Ref_Square(float Angle, double dt)
+{
+    double t = fmod(double(Angle) / 6.283185307179586, 1.0);
+    float v = (0.0f < sinf(Angle)) ? 1.0f : -1.0f;
+    return v + Ref_BLEP(t, dt) - Ref_BLEP(fmod(t + .5, 1.0), dt);
+}
+
+//R1.00 The original synth. SINF per voice, its own phase. Boost is in Ref_FX_Boost.
+float MakoBiteAudioProcessor::Ref_FX_MonoToneSyn(float tSample, float tAnalysis, int channel)
+{
+    tp_chanstate& cs = Chan_State[channel];
+    float tS = tSample;
+    float tS2 = tSample;
+    float Gliss = Setting[e_Gliss] - .01f;
+
+    bool SynthOn = (int(Setting[e_Voice]) != 0) && (.001f <= Setting[e_Mix]);
+    bool MidiOn = Pedal_Midi && (channel == 0);
+    if (!SynthOn && !MidiOn) return tSample;
+
+    //R1.00 VOLUME ENVELOPE.
+    float tP = abs(tanhf(tS * (.01f + Setting[e_PreGain]) * 8.0f));
+    cs.Mod_Peak *= Env_Peak.Coef;
+    if (cs.Mod_Peak < tP) cs.Mod_Peak = tP;
+
+    //R1.00 PITCH DETECTION. Samples between rising zero crossings.
+    cs.Mod_PitchCnt++;
+    tS = tAnalysis;
+
+    if ((cs.Mod_LastSample < 0.0f) && (0.0f < tS))
+    {
+        cs.Mod_PitchInc = (cs.Mod_PitchInc * Gliss) + ((pi2 / cs.Mod_PitchCnt) * (1.0f - Gliss));
+        if (cs.Mod_PitchInc < 0.0f) cs.Mod_PitchInc = 0.0f;
+        cs.Mod_PitchCnt = 0;
+
+        //R1.01 Pitch the phase steps by. The plugin steps a 32 bit phase in whole units of 4PI / 2^32,
+        //R1.01 so the reference takes the same rounded step or the two drift apart over a long note.
+        Ref_Step[channel] = double(juce::uint32(cs.Mod_PitchInc * 341782637.8f)) * (12.566370614359172 / 4294967296.0);
+
+        if (int(Setting[e_Voice]) == VOICE_Sample) Sample_PitchDetected(channel);
+        if (MidiOn) Midi_PitchDetected(channel);
+    }
+    cs.Mod_LastSample = tS;
+
+    if (MidiOn) Midi_CheckGate(channel);
+    if (!SynthOn) return tSample;
+
+    //R1.00 SYNTH SOUND GENERATION. Phase runs 0 to 4PI. Kept in double so the reference does not lose resolution.
+    double& Ph = Ref_Phase[channel];
+    Ph += Ref_Step[channel];
+    if (12.566370614359172 <= Ph) Ph -= 12.566370614359172;
+
+    float x = float(Ph);
+    double dt = juce::jmin(.5, Ref_Step[channel] / 6.283185307179586);
+
+    switch (int(Setting[e_Voice]))
+    {
+        case 1:tS2 = (sinf(x) + sinf(x * 2.0f)); break;
+        case 2:tS2 = .75f * ((cosf(x) + sinf(x * 2.0f) + sinf(float(Ph * 1.5833333333333333)))); break;
+        case 3:tS2 = .5f * Ref_Square(x, dt); break;
+        case 4:tS2 = (Ref_Square(x, dt) + sinf(x * 4.0f)) * .333f; break;
+        case 5:tS2 = sinf(x) + sinf(float(Ph * 1.5833333333333333)); break;
+        case 6:tS2 = sinf(x) + sinf(x * 2.0f); break;
+        case 7:tS2 = sinf(x * 2.0f) + (sinf(x * 4.0f) * .1f); break;
+        case 8:tS2 = sinf(x) + (sinf(x * 2.0f) * .1f); break;
+        case 9:tS2 = sinf(x * .5f) + (sinf(x * 4.0f) * .1f); break;
+        case 10:tS2 = (Ref_Square(x * .5f, dt * .5) + sinf(float(Ph * 1.3340909090909091))) * .333f; break;
+
+        //R1.01 The sample voice is not part of the equivalence run.
+        case VOICE_Sample: tS2 = Sample_Render(channel); break;
+        default: tS2 = 1.5f * sinf(x); break;
+    }
+
+    return tS2 * cs.Mod_Peak;
+}
+
+//R1.00 BOOST and BALANCE.
+//R1.01 SINF every sample as in the original. The makeup gain the plugin added on purpose is worked out here in plain scalar code.
+void MakoBiteAudioProcessor::Ref_FX_Boost(float* Buf, int num, int channel)
+{
+    tp_chanstate& cs = Chan_State[channel];
+    MakoDSP::t_BoostLevel& bl = Boost_Level[channel];
+    float Bal = cs.Pedal_Bal1LR;
+
+    if (Setting[e_Boost] <= 0.0f)
+    {
+        bl = MakoDSP::t_BoostLevel();
+        for (int t = 0; t < num; t++) Buf[t] *= Bal;
+        return;
+    }
+
+    float PreSq = 0.0f;
+    float PostSq = 0.0f;
+    for (int t = 0; t < num; t++)
+    {
+        float x = Buf[t];
+        float y = sinf(x * Setting[e_Boost] * 50.0f);
+        PreSq += x * x;
+        PostSq += y * y;
+        Buf[t] = y;
+    }
+
+    bool Fresh = (bl.PostMS <= MakoDSP::BOOST_Floor);
+    float Blend = Fresh ? 0.0f : powf(Env_Boost.Coef, float(num));
+    bl.PreMS = (bl.PreMS * Blend) + ((PreSq / num) * (1.0f - Blend));
+    bl.PostMS = (bl.PostMS * Blend) + ((PostSq / num) * (1.0f - Blend));
+
+    float Target = bl.Makeup;
+    if (MakoDSP::BOOST_Floor < bl.PostMS) Target = juce::jlimit(MakoDSP::BOOST_MakeupMin, MakoDSP::BOOST_MakeupMax, sqrtf(bl.PreMS / bl.PostMS));
+    if (Fresh) bl.Makeup = Target;
+
+    float Step = (Target - bl.Makeup) / num;
+    for (int t = 0; t < num; t++) Buf[t] *= (bl.Makeup + Step * (t + 1)) * Bal;
+    bl.Makeup = Target;
+}
+
+//R1.00 DIGITAL DELAY.
+float MakoBiteAudioProcessor::Ref_FX_Delay(float tSample, int channel)
+{
+    tp_chanstate& cs = Chan_State[channel];
+    if (Setting[e_DMix] < .001f) return tSample;
+
+    long idx = cs.Delay_B_Idx;
+    float* DB = Delay_B[channel].data();
+
+    float NewSignal = (tSample * Delay_Dry) + ((DB[idx] * Delay_Wet));
+    DB[idx] = (.5f * tSample) + (DB[idx] * Setting[e_DLen]);
+
+    cs.Delay_B_Idx++;
+    if (cs.Delay_B_Idx_Max < cs.Delay_B_Idx) cs.Delay_B_Idx = 0;
+
+    return NewSignal;
+}
+
+#endif
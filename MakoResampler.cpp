@@ -0,0 +1,167 @@
+/*
+  ==============================================================================
+
+    MakoResampler.cpp
+    Halfband polyphase 2x resampler chains. Lets the MonoTone run at a fixed
+    internal rate no matter what rate the host runs at.
+
+  ==============================================================================
+*/
+
+#include "MakoResampler.h"
+#include "MakoBounds.h"
+
+void MakoResampler::Prepare(int Channels, int Stages, int MaxBlock)
+{
+    Stage_Cnt = juce::jlimit(0, MAX_Stages, Stages);
+    Chan_Cnt = juce::jmax(1, Channels);
+
+    //R1.01 Halfband taps. Windowed sinc with a cut off at 1/4 of the high rate. Only the odd taps
+    //R1.01 either side of the center are non zero. Kaiser window, Beta 9.
+    const double Beta = 9.0;
+    auto BesselI0 = [](double x)
+    {
+        double Sum = 1.0, Term = 1.0;
+        for (int k = 1; k < 30; k++)
+        {
+            Term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            Sum += Term;
+        }
+        return Sum;
+    };
+
+    for (int t = 0; t < HB_Pairs; t++)
+    {
+        double n = 2.0 * t + 1.0;                              //R1.01 Distance from the center tap.
+        double r = n / double(HB_Delay + 1);
+        double Win = BesselI0(Beta * sqrt(juce::jmax(0.0, 1.0 - r * r))) / BesselI0(Beta);
+        double Sinc = sin(juce::MathConstants<double>::pi * n * .5) / (juce::MathConstants<double>::pi * n);
+        Coef[t] = float(Sinc * Win);
+    }
+
+    tp_hbstate Clear = {};
+    Down_State.assign(size_t(Chan_Cnt * juce::jmax(1, Stage_Cnt)), Clear);
+    Up_State.assign(size_t(Chan_Cnt * juce::jmax(1, Stage_Cnt)), Clear);
+
+    //R1.01 Up makes 2^Stages samples at a time. Start the FIFO with enough silence that a host
+    //R1.01 block never has to wait for the next group.
+    int Group = 1 << Stage_Cnt;
+    Work.setSize(2, MaxBlock + 2 * Group);
+    Fifo.resize(size_t(Chan_Cnt));
+    for (auto& f : Fifo) f.assign(size_t(2 * MaxBlock + 2 * Group), 0.0f);
+    Fifo_Read = 0;
+    Fifo_Cnt = Group - 1;
+}
+
+int MakoResampler::Latency() const
+{
+    //R1.01 Each Down and Up stage delays HB_Delay samples at its high rate. The FIFO pre fill lines up
+    //R1.01 with the samples Down holds back while it waits for a full group, so it adds nothing.
+    int Group = 1 << Stage_Cnt;
+    return 2 * HB_Delay * (Group - 1);
+}
+
+int MakoResampler::Stage_Down(tp_hbstate* st, const float* Src, int num, float* Dest)
+{
+    int Out = 0;
+    for (int t = 0; t < num; t++)
+    {
+        Hist_Push(st, Src[t]);
+
+        //R1.01 One output for every two inputs.
+        st->Phase ^= 1;
+        if (st->Phase) continue;
+
+        //R1.01 Center tap is .5. The pairs are symmetric around it.
+        const float* h = Hist_Get(st);
+        const int c = HIST_Size - 1 - HB_Delay;
+        float y = .5f * h[c];
+        for (int p = 0; p < HB_Pairs; p++) y += Coef[p] * (h[c + 2 * p + 1] + h[c - 2 * p - 1]);
+        Dest[Out++] = y;
+    }
+    return Out;
+}
+
+void MakoResampler::Stage_Up(tp_hbstate* st, const float* Src, int num, float* Dest)
+{
+    for (int t = 0; t < num; t++)
+    {
+        Hist_Push(st, Src[t]);
+        const float* h = Hist_Get(st);
+        const int n = HIST_Size - 1;
+
+        //R1.01 Even output is the filtered branch, odd output is the center tap (a plain delay).
+        //R1.01 Gain is doubled to make up for the zeros stuffed between samples.
+        float y = 0.0f;
+        for (int p = 0; p < HB_Pairs; p++) y += Coef[p] * (h[n - HB_Pairs + 1 + p] + h[n - HB_Pairs - p]);
+        Dest[2 * t] = 2.0f * y;
+        Dest[2 * t + 1] = h[n - HB_Pairs + 1];
+    }
+}
+
+int MakoResampler::Down(const juce::AudioBuffer<float>& Host, int num, juce::AudioBuffer<float>& Internal)
+{
+    int Chans = juce::jmin(Chan_Cnt, Host.getNumChannels(), Internal.getNumChannels());
+    int Out = num;
+    MAKO_BOUNDS(0, num, Work.getNumSamples(), "Resampler Down Work");
+
+    for (int ch = 0; ch < Chans; ch++)
+    {
+        const float* Src = Host.getReadPointer(ch);
+        int Cnt = num;
+
+        for (int s = 0; s < Stage_Cnt; s++)
+        {
+            float* Dest = (s == Stage_Cnt - 1) ? Internal.getWritePointer(ch) : Work.getWritePointer(s & 1);
+            Cnt = Stage_Down(&Down_State[size_t(ch * Stage_Cnt + s)], Src, Cnt, Dest);
+            Src = Dest;
+        }
+        Out = Cnt;
+    }
+
+    return Out;
+}
+
+void MakoResampler::Up(const juce::AudioBuffer<float>& Internal, int numInternal, juce::AudioBuffer<float>& Host, int num)
+{
+    int Chans = juce::jmin(Chan_Cnt, Host.getNumChannels(), Internal.getNumChannels());
+    int Size = int(Fifo[0].size());
+    int Made = numInternal << Stage_Cnt;
+    MAKO_BOUNDS(0, Made, Work.getNumSamples(), "Resampler Up Work");
+    MAKO_BOUNDS(0, Fifo_Cnt + Made, Size, "Resampler FIFO");
+    MAKO_BOUNDS(0, num, Fifo_Cnt + Made, "Resampler FIFO underrun");
+
+    for (int ch = 0; ch < Chans; ch++)
+    {
+        //R1.01 Run the stages. The last stage writes into the Work buffer it is not reading from.
+        const float* Src = Internal.getReadPointer(ch);
+        int Cnt = numInternal;
+        for (int s = 0; s < Stage_Cnt; s++)
+        {
+            float* Dest = Work.getWritePointer(s & 1);
+            Stage_Up(&Up_State[size_t(ch * Stage_Cnt + s)], Src, Cnt, Dest);
+            Src = Dest;
+            Cnt *= 2;
+        }
+
+        //R1.01 Add to the FIFO then take the host block out of it.
+        float* f = Fifo[size_t(ch)].data();
+        int w = (Fifo_Read + Fifo_Cnt) % Size;
+        for (int t = 0; t < Made; t++)
+        {
+            f[w] = Src[t];
+            if (++w == Size) w = 0;
+        }
+
+        float* Dest = Host.getWritePointer(ch);
+        int r = Fifo_Read;
+        for (int t = 0; t < num; t++)
+        {
+            Dest[t] = f[r];
+            if (++r == Size) r = 0;
+        }
+    }
+
+    Fifo_Cnt += Made - num;
+    Fifo_Read = (Fifo_Read + num) % Size;
+}
@@ -0,0 +1,74 @@
+/*
+  ==============================================================================
+
+    MakoResampler.h
+    Halfband polyphase 2x resampler chains. Lets the MonoTone run at a fixed
+    internal rate no matter what rate the host runs at.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//R1.01 INTERNAL RATE RESAMPLER.
+//R1.01 Each stage halves (Down) or doubles (Up) the sample rate with a linear phase halfband FIR.
+//R1.01 Half of a halfband filter's taps are zero and the rest are symmetric, so each stage only
+//R1.01 costs HB_Pairs multiplies per low rate sample. Stages are chained for 4x, 8x and 16x.
+//R1.01 Up output goes through a small FIFO so every host block gets exactly the samples it asked for.
+class MakoResampler
+{
+public:
+    static const int HB_Pairs = 16;                  //R1.01 Symmetric tap pairs. 63 tap filter, about 90 dB stop band.
+    static const int HB_Taps = 4 * HB_Pairs - 1;
+    static const int HB_Delay = 2 * HB_Pairs - 1;    //R1.01 Group delay at the high rate of a stage.
+    static const int MAX_Stages = 5;
+
+    //R1.01 Not on the audio thread. Stages = number of 2x steps, 0 = off. MaxBlock = largest host block to Down/Up.
+    void Prepare(int Channels, int Stages, int MaxBlock);
+
+    //R1.01 Total delay of a Down and Up round trip in host samples.
+    int Latency() const;
+    int Stages_Get() const { return Stage_Cnt; }
+
+    //R1.01 Host rate to internal rate. Returns the number of internal samples made (same for every channel).
+    int Down(const juce::AudioBuffer<float>& Host, int num, juce::AudioBuffer<float>& Internal);
+
+    //R1.01 Internal rate to host rate. Writes exactly num samples into Host.
+    void Up(const juce::AudioBuffer<float>& Internal, int numInternal, juce::AudioBuffer<float>& Host, int num);
+
+private:
+    //R1.01 History for one stage of one channel. Written twice so reads never wrap.
+    static const int HIST_Size = 4 * HB_Pairs;
+    struct tp_hbstate {
+        float Hist[2 * HIST_Size];
+        int Pos;
+        int Phase;       //R1.01 Down only. 1 = holding the first sample of a pair.
+    };
+
+    int Stage_Cnt = 0;
+    int Chan_Cnt = 0;
+    float Coef[HB_Pairs] = {};
+
+    std::vector<tp_hbstate> Down_State;      //R1.01 [channel * Stage_Cnt + stage]
+    std::vector<tp_hbstate> Up_State;
+    juce::AudioBuffer<float> Work;           //R1.01 Two ping pong buffers between stages.
+
+    std::vector<std::vector<float>> Fifo;    //R1.01 Up output waiting to go to the host. One per channel.
+    int Fifo_Read = 0;
+    int Fifo_Cnt = 0;
+
+    inline void Hist_Push(tp_hbstate* st, float x)
+    {
+        st->Hist[st->Pos] = x;
+        st->Hist[st->Pos + HIST_Size] = x;
+        st->Pos = (st->Pos + 1) % HIST_Size;
+    }
+
+    //R1.01 Oldest to newest, HIST_Size samples. Newest is at [HIST_Size - 1].
+    inline const float* Hist_Get(const tp_hbstate* st) const { return &st->Hist[st->Pos]; }
+
+    int Stage_Down(tp_hbstate* st, const float* Src, int num, float* Dest);
+    void Stage_Up(tp_hbstate* st, const float* Src, int num, float* Dest);
+};
@@ -0,0 +1,248 @@
+/*
+  ==============================================================================
+
+    MakoSampleVoice.cpp
+    WAVE file based voices for the MonoTone synth.
+
+  ==============================================================================
+*/
+
+#include "MakoSampleVoice.h"
+#include "MakoRTCheck.h"
+
+//R1.01 Find which zone plays a note. Zones are sorted so we take the last one that starts below the note.
+int MakoSampleSet::Zone_Find(float Note) const
+{
+    int zone = 0;
+    for (int t = 1; t < int(Zones.size()); t++)
+        if (Zones[t]->LoNote <= Note) zone = t;
+
+    return zone;
+}
+
+//R1.01 Read a sample from the mapped file with linear interpolation. Pos is in file samples.
+//R1.01 The point after the loop end is the loop start.
+float MakoSampleSet::Zone_Sample(const t_SampleZone* zn, double Pos)
+{
+    float S1[2];
+    float S2[2];
+
+    juce::int64 idx = juce::int64(Pos);
+    float frac = float(Pos - double(idx));
+    juce::int64 idx2 = idx + 1;
+    if (zn->LoopEnd <= idx2) idx2 -= zn->LoopEnd - zn->LoopStart;
+
+    zn->Reader->getSample(idx, S1);
+    zn->Reader->getSample(idx2, S2);
+
+    return S1[0] + (S2[0] - S1[0]) * frac;
+}
+
+//R1.01 Read a sample at Pos (0 to LoopEnd). Near the loop end, blend toward the audio one loop length back,
+//R1.01 just before LoopStart. That is where the wrap lands, so the two sides of the wrap match.
+float MakoSampleSet::Zone_Read(int zone, double Pos) const
+{
+    const t_SampleZone* zn = Zones[zone].get();
+    float tS = Zone_Sample(zn, Pos);
+
+    double FadeStart = double(zn->LoopEnd - zn->Fade);
+    if ((0 < zn->Fade) && (FadeStart <= Pos))
+    {
+        float g = float((Pos - FadeStart) / double(zn->Fade));
+        tS += (Zone_Sample(zn, Pos - double(zn->LoopEnd - zn->LoopStart)) - tS) * g;
+    }
+
+    return tS;
+}
+
+//R1.01 Loop points from the smpl chunk (JUCE puts them in the reader's metadata). Without them the whole
+//R1.01 file loops. Either way the wrap is crossfaded over up to LOOP_FadeSec, as much as fits before LoopStart.
+void MakoSampleSet::Zone_Loop(t_SampleZone* zn, const juce::StringPairArray& Meta)
+{
+    zn->LoopStart = 0;
+    zn->LoopEnd = zn->Length;
+    zn->Fade = 0;
+    if (zn->SingleCycle) return;
+
+    juce::int64 FadeMax = juce::jmax(juce::int64(1), juce::int64(zn->FileRate * LOOP_FadeSec));
+    if (0 < Meta.getValue("NumSampleLoops", "0").getIntValue())
+    {
+        //R1.01 smpl loop ends are the last sample played, so one past it is our LoopEnd.
+        juce::int64 Start = Meta.getValue("Loop0Start", "0").getLargeIntValue();
+        juce::int64 End = Meta.getValue("Loop0End", "0").getLargeIntValue() + 1;
+        if ((0 <= Start) && (Start + 2 <= End) && (End <= zn->Length))
+        {
+            zn->LoopStart = Start;
+            zn->LoopEnd = End;
+            zn->Fade = juce::jmin(FadeMax, Start, (End - Start) / 2);
+            return;
+        }
+    }
+
+    //R1.01 No usable loop. Loop the file after the first Fade samples, which are what the end fades into.
+    zn->Fade = juce::jmin(FadeMax, zn->Length / 4);
+    zn->LoopStart = zn->Fade;
+}
+
+std::unique_ptr<t_SampleZone> MakoSampleSet::Zone_Load(const juce::File& WavFile)
+{
+    juce::WavAudioFormat wavFormat;
+
+    //R1.01 Map the file. Nothing is read into the heap.
+    std::unique_ptr<juce::MemoryMappedAudioFormatReader> Reader(wavFormat.createMemoryMappedReader(WavFile));
+    if (Reader == nullptr) return nullptr;
+
+    //R1.01 Our read buffer only holds 2 channels. Only the first channel is played.
+    if ((Reader->numChannels < 1) || (2 < Reader->numChannels)) return nullptr;
+    if (Reader->lengthInSamples < 2) return nullptr;
+    if (!Reader->mapEntireFile()) return nullptr;
+
+    auto zn = std::make_unique<t_SampleZone>();
+    zn->Length = Reader->lengthInSamples;
+    zn->FileRate = Reader->sampleRate;
+    zn->SingleCycle = (zn->Length <= SINGLECYCLE_Max);
+
+    //R1.01 The root note is the number at the end of the file name. Bass_40.wav = MIDI note 40 (E2).
+    //R1.01 Files without a number are treated as A2 (110 Hz).
+    int Root = WavFile.getFileNameWithoutExtension().getTrailingIntValue();
+    if ((Root <= 0) || (127 < Root)) Root = 45;
+    zn->RootFreq = 440.0f * powf(2.0f, (Root - 69) / 12.0f);
+    zn->LoNote = float(Root);
+
+    Zone_Loop(zn.get(), Reader->metadataValues);
+    zn->Reader = std::move(Reader);
+    return zn;
+}
+
+//R1.01 Build a sample set from a single WAVE file or a folder of WAVE files. Background thread only.
+MakoSampleSet* MakoSampleSet::Load(const juce::File& Source)
+{
+    auto Set = std::make_unique<MakoSampleSet>();
+
+    if (Source.isDirectory())
+    {
+        auto Files = Source.findChildFiles(juce::File::findFiles, false, "*.wav");
+        for (auto& f : Files)
+        {
+            auto zn = Zone_Load(f);
+            if (zn != nullptr) Set->Zones.push_back(std::move(zn));
+        }
+    }
+    else
+    {
+        auto zn = Zone_Load(Source);
+        if (zn != nullptr) Set->Zones.push_back(std::move(zn));
+    }
+
+    if (Set->Zones.empty()) return nullptr;
+
+    //R1.01 Sort low to high. Each zone starts half way between its root and the root below it.
+    std::sort(Set->Zones.begin(), Set->Zones.end(), [](const std::unique_ptr<t_SampleZone>& a, const std::unique_ptr<t_SampleZone>& b) { return a->LoNote < b->LoNote; });
+
+    float LastRoot = Set->Zones[0]->LoNote;
+    Set->Zones[0]->LoNote = 0.0f;
+    for (size_t t = 1; t < Set->Zones.size(); t++)
+    {
+        float Root = Set->Zones[t]->LoNote;
+        Set->Zones[t]->LoNote = (LastRoot + Root) * .5f;
+        LastRoot = Root;
+    }
+
+    return Set.release();
+}
+
+//==============================================================================
+MakoSampleThread::MakoSampleThread() : juce::Thread("Mako Sample Loader")
+{
+    startThread();
+}
+
+MakoSampleThread::~MakoSampleThread()
+{
+    //R1.01 Every instance has let go of us by now, so the queue is empty.
+    stopThread(2000);
+}
+
+void MakoSampleThread::Queue_Add(MakoSampleLoader* Slot, const juce::File& Source)
+{
+    MAKO_RTCHECK_BLOCKING("MakoSampleThread::Queue_Add lock");
+    {
+        const juce::ScopedLock sl(QueueLock);
+        Slot->RequestFile = Source;
+        if (std::find(Queue.begin(), Queue.end(), Slot) == Queue.end()) Queue.push_back(Slot);
+    }
+    notify();
+}
+
+void MakoSampleThread::Queue_Cancel(MakoSampleLoader* Slot)
+{
+    {
+        const juce::ScopedLock sl(QueueLock);
+        Queue.erase(std::remove(Queue.begin(), Queue.end(), Slot), Queue.end());
+    }
+
+    //R1.01 A load for Slot may be running. It is finished once we get the job lock.
+    const juce::ScopedLock jl(JobLock);
+}
+
+void MakoSampleThread::run()
+{
+    while (!threadShouldExit())
+    {
+        //R1.01 Sleep until Queue_Add or stopThread signals us.
+        wait(-1);
+
+        while (!threadShouldExit())
+        {
+            const juce::ScopedLock jl(JobLock);
+            MakoSampleLoader* Slot = nullptr;
+            juce::File Source;
+            {
+                const juce::ScopedLock sl(QueueLock);
+                if (Queue.empty()) break;
+                Slot = Queue.front();
+                Queue.erase(Queue.begin());
+                Source = Slot->RequestFile;
+            }
+
+            //R1.01 The audio thread only retires a set after picking up one we made, so the last
+            //R1.01 retired set is freed here, before the next one can arrive.
+            delete Slot->Retired.exchange(nullptr);
+
+            //R1.01 A set the audio thread never picked up can be freed right away.
+            MakoSampleSet* Set = MakoSampleSet::Load(Source);
+            if (Set != nullptr) delete Slot->Pending.exchange(Set);
+        }
+    }
+}
+
+//==============================================================================
+MakoSampleLoader::~MakoSampleLoader()
+{
+    Loader->Queue_Cancel(this);
+    delete Pending.exchange(nullptr);
+    delete Retired.exchange(nullptr);
+}
+
+void MakoSampleLoader::Request(const juce::File& Source)
+{
+    Loader->Queue_Add(this, Source);
+}
+
+MakoSampleSet* MakoSampleLoader::Acquire(MakoSampleSet* Active)
+{
+    //R1.01 The last set we retired has not been freed yet. Try again next block.
+    if (Retired.load() != nullptr) return Active;
+
+    MakoSampleSet* New = Pending.exchange(nullptr);
+    if (New == nullptr) return Active;
+
+    //R1.01 The loader thread frees the old set. Nothing is freed on the audio thread.
+    Retired.store(Active);
+    return New;
+}
+
+void MakoSampleLoader::Release(MakoSampleSet* Active)
+{
+    delete Active;
+}
@@ -0,0 +1,111 @@
+/*
+  ==============================================================================
+
+    MakoSampleVoice.h
+    WAVE file based voices for the MonoTone synth.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//R1.01 One WAVE file mapped into memory. The file is not copied to the heap, the OS pages it in
+//R1.01 as we read it. Every plugin instance that maps the same file shares the same memory pages.
+struct t_SampleZone {
+    std::unique_ptr<juce::MemoryMappedAudioFormatReader> Reader;
+    juce::int64 Length = 0;        //R1.01 Samples in the file.
+    double FileRate = 48000.0;     //R1.01 Sample rate of the file.
+    float RootFreq = 440.0f;       //R1.01 Pitch the file was recorded at. Not used for single cycles.
+    float LoNote = 0.0f;           //R1.01 Lowest MIDI note this zone plays.
+    bool SingleCycle = false;      //R1.01 Short files are treated as one cycle of a waveform.
+
+    //R1.01 Loop. Play from 0, then repeat LoopStart up to (not including) LoopEnd. The last Fade samples
+    //R1.01 before LoopEnd are crossfaded with the Fade samples before LoopStart so the wrap does not click.
+    juce::int64 LoopStart = 0;
+    juce::int64 LoopEnd = 0;
+    juce::int64 Fade = 0;
+};
+
+//R1.01 A complete sample voice. One file (single cycle or one zone) or a folder of files spread
+//R1.01 across the guitar range. Never changed after it is built so the audio thread can read it freely.
+class MakoSampleSet
+{
+public:
+    std::vector<std::unique_ptr<t_SampleZone>> Zones;   //R1.01 Sorted from low to high note.
+
+    //R1.01 Files up to this length are played as a single cycle waveform.
+    static const int SINGLECYCLE_Max = 4096;
+
+    //R1.01 Longest loop crossfade, in seconds of the file.
+    static constexpr double LOOP_FadeSec = .05;
+
+    int Zone_Find(float Note) const;
+    float Zone_Read(int zone, double Pos) const;
+
+    static MakoSampleSet* Load(const juce::File& Source);
+
+private:
+    static std::unique_ptr<t_SampleZone> Zone_Load(const juce::File& WavFile);
+    static void Zone_Loop(t_SampleZone* zn, const juce::StringPairArray& Meta);
+    static float Zone_Sample(const t_SampleZone* zn, double Pos);
+};
+
+class MakoSampleLoader;
+
+//R1.01 The one loader thread for the process. Hold it with juce::SharedResourcePointer<MakoSampleThread>.
+//R1.01 It waits on its event and only wakes for a request (or to exit). No polling.
+class MakoSampleThread : public juce::Thread
+{
+public:
+    MakoSampleThread();
+    ~MakoSampleThread() override;
+
+    //R1.01 Message thread. Queue a load for this instance. A second request before the first runs replaces it.
+    void Queue_Add(MakoSampleLoader* Slot, const juce::File& Source);
+
+    //R1.01 Message thread. Drop any queued load for this instance and wait out one that is running.
+    void Queue_Cancel(MakoSampleLoader* Slot);
+
+    void run() override;
+
+private:
+    juce::CriticalSection QueueLock;        //R1.01 Never taken on the audio thread.
+    juce::CriticalSection JobLock;          //R1.01 Held while a load runs. Queue_Cancel waits on it.
+    std::vector<MakoSampleLoader*> Queue;
+
+    JUCE_DECLARE_NON_COPYABLE(MakoSampleThread)
+};
+
+//R1.01 Loads sample voices on a background thread and hands them to the audio thread without locks.
+//R1.01 One per plugin instance. The loading itself is done by one MakoSampleThread shared by every
+//R1.01 instance in the process, which sleeps until a request comes in.
+//R1.01 Pending holds a new set waiting for the audio thread. Retired holds the old set the audio
+//R1.01 thread is done with. It is freed by the loader thread at the next request, or when this is destroyed.
+class MakoSampleLoader
+{
+public:
+    MakoSampleLoader() = default;
+    ~MakoSampleLoader();
+
+    //R1.01 Message thread. Ask for a file or folder to be loaded.
+    void Request(const juce::File& Source);
+
+    //R1.01 Audio thread. Returns the set to use from now on (may be the same one).
+    MakoSampleSet* Acquire(MakoSampleSet* Active);
+
+    //R1.01 Only call when audio is stopped. Frees the set the audio thread was using.
+    void Release(MakoSampleSet* Active);
+
+private:
+    friend class MakoSampleThread;
+    juce::SharedResourcePointer<MakoSampleThread> Loader;
+
+    juce::File RequestFile;                 //R1.01 Guarded by the loader's queue lock.
+
+    std::atomic<MakoSampleSet*> Pending { nullptr };
+    std::atomic<MakoSampleSet*> Retired { nullptr };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MakoSampleLoader)
+};
@@ -0,0 +1,36 @@
+/*
+  ==============================================================================
+
+    MakoSharedTables.cpp
+    Read only lookup tables shared by every plugin instance in the process.
+
+  ==============================================================================
+*/
+
+#include "MakoSharedTables.h"
+
+MakoSharedTables::MakoSharedTables()
+{
+    //R1.01 One sine cycle plus a guard point so the interpolation never reads past the end.
+    MakoDSP::Sin_Fill(SIN_Table);
+
+    //R1.00 Ten tick mark angles around a slider.
+    const float TICK_Angle[TICK_Cnt] = { 8.79645920f, 8.29380417f, 7.79114914f, 7.28849411f, 6.78583908f, 6.28318405f, 5.78052902f, 5.27787399f, 4.77521896f, 4.27256393f, 3.76f }; //3.76990914
+
+    //R1.00 Do some PRECALC on Sin/Cos since they are expensive on CPU.
+    for (int t = 0; t < TICK_Cnt; t++)
+    {
+        TICK_Cos[t] = std::cos(TICK_Angle[t]);
+        TICK_Sin[t] = std::sin(TICK_Angle[t]);
+    }
+}
+
+//R1.01 Drop map entries whose table has been freed by every instance.
+void MakoSharedTables::Tables_Prune()
+{
+    for (auto it = Tables.begin(); it != Tables.end();)
+    {
+        if (it->second.expired()) it = Tables.erase(it);
+        else ++it;
+    }
+}
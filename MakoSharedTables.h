@@ -0,0 +1,72 @@
+/*
+  ==============================================================================
+
+    MakoSharedTables.h
+    Read only lookup tables shared by every plugin instance in the process.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include "MakoDSP.h"
+#include <unordered_map>
+
+//R1.01 SHARED TABLES.
+//R1.01 A session can have dozens of MonoTones loaded. Tables that are the same for every instance
+//R1.01 are built once and shared. Hold one with juce::SharedResourcePointer<MakoSharedTables>.
+//R1.01 The registry lives while any instance holds it. The last one out frees it.
+//R1.01   Fixed tables (sine, knob ticks) are built when the registry is created.
+//R1.01   Keyed tables (filter coefficients per sample rate) are built on first request and freed
+//R1.01   when the last instance using that key lets go of its shared_ptr.
+//R1.01 Tables are never changed once built, so the audio thread can read them without locks.
+class MakoSharedTables
+{
+public:
+    MakoSharedTables();
+
+    //R1.01 Oscillator sine table. One cycle plus a guard point for interpolation.
+    static const int SIN_Bits = MakoDSP::SIN_Bits;
+    static const int SIN_Size = MakoDSP::SIN_Size;
+    float SIN_Table[SIN_Size + 1] = {};
+
+    //R1.01 Knob tick mark positions for the editor.
+    static const int TICK_Cnt = 11;
+    float TICK_Cos[TICK_Cnt] = {};
+    float TICK_Sin[TICK_Cnt] = {};
+
+    //R1.01 Table ids for keyed tables.
+    enum { e_Table_LP };
+
+    //R1.01 Make a key from a table id, sample rate and quality setting.
+    static juce::int64 Table_Key(int TableID, double SampleRate, int Quality)
+    {
+        return (juce::int64(SampleRate + .5) << 16) | (juce::int64(Quality & 0xFF) << 8) | juce::int64(TableID & 0xFF);
+    }
+
+    //R1.01 Get a keyed table, building it with Build if no instance holds one. Never call on the audio thread.
+    template <typename T, typename F>
+    std::shared_ptr<const T> Table_Get(juce::int64 Key, F&& Build)
+    {
+        const juce::ScopedLock sl(TableLock);
+
+        auto& Entry = Tables[Key];
+        auto Table = std::static_pointer_cast<const T>(Entry.lock());
+        if (Table != nullptr) return Table;
+
+        auto New = std::make_shared<T>();
+        Build(*New);
+        Entry = New;
+        Tables_Prune();
+        return New;
+    }
+
+private:
+    juce::CriticalSection TableLock;
+    std::unordered_map<juce::int64, std::weak_ptr<const void>> Tables;
+
+    void Tables_Prune();
+
+    JUCE_DECLARE_NON_COPYABLE(MakoSharedTables)
+};
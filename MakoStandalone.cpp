@@ -0,0 +1,213 @@
+/*
+  ==============================================================================
+
+    MakoStandalone.cpp
+    Our own stand alone application, used in place of the JUCE one when the
+    Standalone target is built with JUCE_USE_CUSTOM_PLUGIN_STANDALONE_APP=1.
+
+    MonoTone [--live] [--buffer n] [--rate hz] [--priority p] [--device name]
+    MonoTone --latency-test [--loopback [delay]] [--buffer n] [--rate hz] [--device name]
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+
+#if JucePlugin_Build_Standalone && JUCE_USE_CUSTOM_PLUGIN_STANDALONE_APP
+
+#include <juce_audio_plugin_client/Standalone/juce_StandaloneFilterWindow.h>
+#include "PluginProcessor.h"
+#include "MakoLive.h"
+
+//R1.01 STAND ALONE LIVE BOX.
+//R1.01   --live          Lock memory, pick the smallest buffer the device allows (or --buffer), and run the
+//R1.01                   audio thread at real time priority with denormals off.
+//R1.01   --latency-test  No window. Measure round trip and pitch tracking delay, print them and quit.
+//R1.01                   Needs a cable from output 1 to input 1, or --loopback for a built in fake device.
+class MakoStandaloneApp : public juce::JUCEApplication
+{
+public:
+    MakoStandaloneApp()
+    {
+        juce::PropertiesFile::Options Options;
+        Options.applicationName = getApplicationName();
+        Options.filenameSuffix = ".settings";
+        Options.osxLibrarySubFolder = "Application Support";
+        Options.folderName = "MakoMonoTone";
+        AppProperties.setStorageParameters(Options);
+    }
+
+    const juce::String getApplicationName() override { return JucePlugin_Name; }
+    const juce::String getApplicationVersion() override { return JucePlugin_VersionString; }
+    bool moreThanOneInstanceAllowed() override { return true; }
+    void anotherInstanceStarted(const juce::String&) override {}
+
+    void initialise(const juce::String& CommandLine) override
+    {
+        juce::StringArray Args = juce::StringArray::fromTokens(CommandLine, true);
+        Live = Args.contains("--live");
+        Buffer = Arg_Int(Args, "--buffer", Live ? 32 : 0);
+        Rate = Arg_Int(Args, "--rate", 0);
+        Priority = Arg_Int(Args, "--priority", 80);
+        Device = Arg_String(Args, "--device");
+
+        if (Args.contains("--latency-test"))
+        {
+            int Loop = Args.indexOf("--loopback");
+            int LoopDelay = ((0 <= Loop) && Args[Loop + 1].containsOnly("0123456789")) ? Args[Loop + 1].getIntValue() : 0;
+            setApplicationReturnValue(Latency_Test(0 <= Loop, LoopDelay) ? 0 : 1);
+            quit();
+            return;
+        }
+
+        //R1.01 Memory is locked first so the plugin and its buffers are locked as they are made.
+        if (Live)
+        {
+            juce::String Error;
+            if (!MakoLive::Memory_Lock(Error)) std::cout << Error << std::endl;
+        }
+
+        Window = std::make_unique<juce::StandaloneFilterWindow>(getApplicationName(),
+            juce::LookAndFeel::getDefaultLookAndFeel().findColour(juce::ResizableWindow::backgroundColourId),
+            AppProperties.getUserSettings(), false, Device);
+        Window->setVisible(true);
+
+        if (Live) Live_Start(Window->getPluginHolder()->deviceManager);
+    }
+
+    void shutdown() override
+    {
+        if ((Window != nullptr) && (LiveCallback != nullptr))
+            Window->getPluginHolder()->deviceManager.removeAudioCallback(LiveCallback.get());
+        Window = nullptr;
+        LiveCallback = nullptr;
+    }
+
+    void systemRequestedQuit() override
+    {
+        if (Window != nullptr) Window->pluginHolder->savePluginState();
+        quit();
+    }
+
+private:
+    juce::ApplicationProperties AppProperties;
+    std::unique_ptr<juce::StandaloneFilterWindow> Window;
+    std::unique_ptr<MakoLiveCallback> LiveCallback;
+
+    bool Live = false;
+    int Buffer = 0;
+    int Rate = 0;
+    int Priority = 80;
+    juce::String Device;
+
+    static int Arg_Int(const juce::StringArray& Args, const char* Name, int Default)
+    {
+        int i = Args.indexOf(Name);
+        return ((0 <= i) && (i + 1 < Args.size())) ? Args[i + 1].getIntValue() : Default;
+    }
+
+    static juce::String Arg_String(const juce::StringArray& Args, const char* Name)
+    {
+        int i = Args.indexOf(Name);
+        return ((0 <= i) && (i + 1 < Args.size())) ? Args[i + 1].unquoted() : juce::String();
+    }
+
+    //R1.01 Buffer size and rate, then our callback goes in ahead of the plugin on the audio thread.
+    void Live_Setup(juce::AudioDeviceManager& Devices)
+    {
+        juce::AudioDeviceManager::AudioDeviceSetup Setup = Devices.getAudioDeviceSetup();
+        if (auto* Dev = Devices.getCurrentAudioDevice())
+        {
+            if (0 < Buffer) Setup.bufferSize = MakoLive::Buffer_Pick(*Dev, Buffer);
+            if (0 < Rate) Setup.sampleRate = Rate;
+            juce::String Error = Devices.setAudioDeviceSetup(Setup, true);
+            if (Error.isNotEmpty()) std::cout << Error << std::endl;
+        }
+    }
+
+    void Live_Start(juce::AudioDeviceManager& Devices)
+    {
+        Live_Setup(Devices);
+        LiveCallback = std::make_unique<MakoLiveCallback>(Priority);
+        Devices.addAudioCallback(LiveCallback.get());
+
+        if (auto* Dev = Devices.getCurrentAudioDevice())
+        {
+            std::cout << "Live: " << Dev->getName() << ", " << Dev->getCurrentBufferSizeSamples() << " samples at "
+                      << Dev->getCurrentSampleRate() << " Hz, " << (Dev->getOutputLatencyInSamples() + Dev->getInputLatencyInSamples())
+                      << " samples reported I/O latency." << std::endl;
+        }
+    }
+
+    bool Latency_Test(bool Loopback, int LoopDelay)
+    {
+        juce::AudioDeviceManager Devices;
+        juce::String Error;
+
+        if (Loopback)
+        {
+            //R1.01 Built in fake device. Default loop is two buffers, like a typical card.
+            int Block = (0 < Buffer) ? Buffer : 64;
+            auto Loop = std::make_unique<MakoLoopbackDevice>((0 < LoopDelay) ? LoopDelay : 2 * Block, false);
+            Error = Loop->open(3, 3, (0 < Rate) ? Rate : 48000.0, Block);
+            if (Error.isEmpty())
+            {
+                MakoLatencyTest::t_Result R = Latency_Device(*Loop);
+                Loop->close();
+                return Latency_Print(R, "MonoTone Loopback");
+            }
+        }
+        else
+        {
+            Error = Devices.initialise(2, 2, nullptr, true, Device);
+            if (Error.isEmpty())
+            {
+                Live_Setup(Devices);
+                auto* Dev = Devices.getCurrentAudioDevice();
+                if (Dev == nullptr)
+                    Error = "No audio device.";
+                else
+                    return Latency_Print(MakoLatency_Run(Devices, 30000), Dev->getName());
+            }
+        }
+
+        std::cout << Error << std::endl;
+        return false;
+    }
+
+    //R1.01 The loopback device has no device manager. Run the test on it directly.
+    static MakoLatencyTest::t_Result Latency_Device(juce::AudioIODevice& Dev)
+    {
+        MakoLatencyTest Test;
+        Dev.start(&Test);
+        double Start = juce::Time::getMillisecondCounterHiRes();
+        while (!Test.Finished() && (juce::Time::getMillisecondCounterHiRes() - Start < 30000.0)) juce::Thread::sleep(1);
+        Dev.stop();
+
+        if (!Test.Finished())
+        {
+            MakoLatencyTest::t_Result R;
+            R.Error = "Timed out.";
+            return R;
+        }
+        return Test.Result_Get();
+    }
+
+    static bool Latency_Print(const MakoLatencyTest::t_Result& R, const juce::String& Name)
+    {
+        auto Ms = [&R](double Samples) { return (0.0 < R.Rate) ? 1000.0 * Samples / R.Rate : 0.0; };
+
+        std::cout << "Latency test on " << Name << ", " << R.Block << " samples at " << R.Rate << " Hz." << std::endl;
+        std::cout << "Round trip (input to output): " << R.RoundTrip << " samples, " << Ms(R.RoundTrip) << " ms ("
+                  << R.Clicks << " clicks)." << std::endl;
+        std::cout << "Pitch tracking: avg " << Ms(R.Track_Avg) << " ms, max " << Ms(R.Track_Max) << " ms ("
+                  << R.Tracked << " of " << R.Notes << " notes, includes " << R.Plugin_Latency << " samples plugin latency)." << std::endl;
+        if (!R.Ok) std::cout << "FAILED: " << R.Error << std::endl;
+        return R.Ok;
+    }
+};
+
+juce::JUCEApplicationBase* juce_CreateApplication();
+juce::JUCEApplicationBase* juce_CreateApplication() { return new MakoStandaloneApp(); }
+
+#endif
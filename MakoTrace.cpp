@@ -0,0 +1,220 @@
+/*
+  ==============================================================================
+
+    MakoTrace.cpp
+    Timeline tracing of our processing. Writes Chrome trace event JSON that
+    loads in Perfetto (ui.perfetto.dev) or chrome://tracing.
+
+  ==============================================================================
+*/
+
+#include "MakoTrace.h"
+#include "MakoRTCheck.h"
+
+#if MAKO_TRACE
+
+namespace MakoTrace
+{
+    //R1.01 One ring per thread that records spans. Single writer (its thread), single reader (Writer).
+    //R1.01 Rings are made by the Writer, so nothing is allocated until tracing starts, and a thread claims
+    //R1.01 a free one without allocating. When the thread ends its ring goes back to the Writer, which
+    //R1.01 frees it for the next thread once it has written out what is left. Rings are never deleted.
+    static const int TRACE_Threads = 64;         //R1.01 Most threads tracing at the same time.
+    static const int TRACE_Spare = 4;            //R1.01 Free rings the Writer keeps ready.
+    static const int TRACE_RingSize = 16384;     //R1.01 Power of 2.
+
+    enum { e_Ring_Free, e_Ring_Used, e_Ring_Done };
+
+    struct t_TraceRing {
+        std::atomic<int> State { e_Ring_Free };
+        std::atomic<int> Tid { 0 };
+        std::atomic<juce::uint32> WriteIdx { 0 };
+        std::atomic<juce::uint32> ReadIdx { 0 };
+        std::atomic<juce::uint32> Dropped { 0 };
+        t_TraceEvent Events[TRACE_RingSize];
+    };
+
+    static std::atomic<t_TraceRing*> Trace_Rings[TRACE_Threads] = {};
+    static std::atomic<int> Trace_FreeCnt { 0 };
+    static std::atomic<int> Trace_TidNext { 1 };
+    static std::atomic<juce::uint32> Trace_Dropped { 0 };   //R1.01 Spans of threads that had no ring, and of recycled rings.
+
+    //R1.01 Hands this thread's ring back when the thread ends. Only touched when a ring is claimed:
+    //R1.01 the first touch registers the thread exit call, which allocates once per thread.
+    struct t_TraceOwner {
+        t_TraceRing* Ring = nullptr;
+        ~t_TraceOwner() { if (Ring != nullptr) Ring->State.store(e_Ring_Done, std::memory_order_release); }
+    };
+    static thread_local t_TraceOwner Trace_Owner;
+    static thread_local t_TraceRing* Trace_MyRing = nullptr;
+
+    //R1.01 Claim a free ring. nullptr if the Writer has none ready.
+    static t_TraceRing* Ring_Claim() noexcept
+    {
+        if (Trace_FreeCnt.load(std::memory_order_relaxed) <= 0) return nullptr;
+
+        for (int t = 0; t < TRACE_Threads; t++)
+        {
+            t_TraceRing* Ring = Trace_Rings[t].load(std::memory_order_acquire);
+            if (Ring == nullptr) continue;
+
+            int Free = e_Ring_Free;
+            if (Ring->State.compare_exchange_strong(Free, e_Ring_Used, std::memory_order_acq_rel))
+            {
+                Trace_FreeCnt.fetch_sub(1, std::memory_order_relaxed);
+                Ring->Tid.store(Trace_TidNext.fetch_add(1, std::memory_order_relaxed), std::memory_order_relaxed);
+                return Ring;
+            }
+        }
+        return nullptr;
+    }
+
+    void Push(const char* Name, const void* Instance, juce::int64 Begin, juce::int64 End) noexcept
+    {
+        //R1.01 First span on this thread. Claim a ring, or drop the span and try again next time.
+        if (Trace_MyRing == nullptr)
+        {
+            Trace_MyRing = Ring_Claim();
+            if (Trace_MyRing == nullptr)
+            {
+                Trace_Dropped.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+
+            MAKO_RTCHECK_ALLOW_SCOPE;
+            Trace_Owner.Ring = Trace_MyRing;
+        }
+
+        t_TraceRing* Ring = Trace_MyRing;
+        juce::uint32 w = Ring->WriteIdx.load(std::memory_order_relaxed);
+
+        //R1.01 Ring is full. Drop the span rather than wait for the writer.
+        if (TRACE_RingSize <= juce::uint32(w - Ring->ReadIdx.load(std::memory_order_acquire)))
+        {
+            Ring->Dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        Ring->Events[w & (TRACE_RingSize - 1)] = { Name, Instance, Begin, End };
+        Ring->WriteIdx.store(w + 1, std::memory_order_release);
+    }
+
+    //R1.01 Writer thread. Keep TRACE_Spare free rings ready, as long as there are slots left.
+    static void Rings_Top()
+    {
+        for (int t = 0; (t < TRACE_Threads) && (Trace_FreeCnt.load() < TRACE_Spare); t++)
+        {
+            if (Trace_Rings[t].load() != nullptr) continue;
+            Trace_Rings[t].store(new t_TraceRing(), std::memory_order_release);
+            Trace_FreeCnt.fetch_add(1);
+        }
+    }
+
+    //==============================================================================
+    Writer::Writer() : juce::Thread("Mako Trace Writer")
+    {
+        juce::String Path = juce::SystemStats::getEnvironmentVariable("MAKO_TRACE_FILE", {});
+        juce::File TraceFile = Path.isNotEmpty() ? juce::File::getCurrentWorkingDirectory().getChildFile(Path)
+                                                 : juce::File::getSpecialLocation(juce::File::tempDirectory).getChildFile("MakoTrace.json");
+
+        TraceFile.deleteFile();
+        Stream = std::make_unique<juce::FileOutputStream>(TraceFile);
+        if (!Stream->openedOk())
+        {
+            Stream.reset();
+            return;
+        }
+
+        //R1.01 Chrome trace JSON array format. Times are in microseconds from when tracing started.
+        StartTicks = juce::Time::getHighResolutionTicks();
+        TicksToUs = 1000000.0 / double(juce::Time::getHighResolutionTicksPerSecond());
+        Stream->writeText("[\n", false, false, nullptr);
+        Rings_Top();
+        startThread();
+    }
+
+    Writer::~Writer()
+    {
+        if (Stream == nullptr) return;
+
+        stopThread(2000);
+        Drain();
+
+        //R1.01 Note any spans lost because the writer fell behind or a thread had no ring.
+        juce::uint32 Dropped = Trace_Dropped.load();
+        for (int t = 0; t < TRACE_Threads; t++)
+        {
+            t_TraceRing* Ring = Trace_Rings[t].load();
+            if (Ring != nullptr) Dropped += Ring->Dropped.load();
+        }
+        if (0 < Dropped)
+        {
+            juce::String Line;
+            Line << (First ? "" : ",\n") << "{\"name\":\"dropped " << int(Dropped) << " spans\",\"ph\":\"i\",\"s\":\"g\",\"pid\":1,\"tid\":0,\"ts\":0}";
+            Stream->writeText(Line, false, false, nullptr);
+            First = false;
+        }
+
+        Stream->writeText("\n]\n", false, false, nullptr);
+        Stream->flush();
+    }
+
+    void Writer::Drain()
+    {
+        for (int t = 0; t < TRACE_Threads; t++)
+        {
+            t_TraceRing* Ring = Trace_Rings[t].load(std::memory_order_acquire);
+            if (Ring == nullptr) continue;
+
+            //R1.01 Read the state first. A ring that is done before we drain it gets nothing more.
+            int State = Ring->State.load(std::memory_order_acquire);
+            if (State == e_Ring_Free) continue;
+
+            int Tid = Ring->Tid.load(std::memory_order_relaxed);
+            juce::uint32 r = Ring->ReadIdx.load(std::memory_order_relaxed);
+            juce::uint32 w = Ring->WriteIdx.load(std::memory_order_acquire);
+
+            for (; r != w; r++)
+            {
+                const t_TraceEvent& Ev = Ring->Events[r & (TRACE_RingSize - 1)];
+                double ts = double(Ev.Begin - StartTicks) * TicksToUs;
+                double dur = double(Ev.End - Ev.Begin) * TicksToUs;
+
+                //R1.01 "X" = complete event. tid numbers the threads in the order they started tracing,
+                //R1.01 inst tells the plugin instances apart.
+                juce::String Line;
+                Line << (First ? "" : ",\n")
+                     << "{\"name\":\"" << Ev.Name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << Tid
+                     << ",\"ts\":" << juce::String(ts, 3) << ",\"dur\":" << juce::String(dur, 3)
+                     << ",\"args\":{\"inst\":\"" << juce::String::toHexString(juce::pointer_sized_int(Ev.Instance)) << "\"}}";
+                Stream->writeText(Line, false, false, nullptr);
+                First = false;
+            }
+
+            //R1.01 Its thread has ended and everything is written. Free the ring for the next thread.
+            if (State == e_Ring_Done)
+            {
+                Trace_Dropped.fetch_add(Ring->Dropped.exchange(0));
+                Ring->WriteIdx.store(0, std::memory_order_relaxed);
+                Ring->ReadIdx.store(0, std::memory_order_relaxed);
+                Ring->State.store(e_Ring_Free, std::memory_order_release);
+                Trace_FreeCnt.fetch_add(1);
+                continue;
+            }
+
+            Ring->ReadIdx.store(r, std::memory_order_release);
+        }
+    }
+
+    void Writer::run()
+    {
+        while (!threadShouldExit())
+        {
+            wait(50);
+            Drain();
+            Rings_Top();
+        }
+    }
+}
+
+#endif
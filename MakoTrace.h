@@ -0,0 +1,78 @@
+/*
+  ==============================================================================
+
+    MakoTrace.h
+    Timeline tracing of our processing. Writes Chrome trace event JSON that
+    loads in Perfetto (ui.perfetto.dev) or chrome://tracing.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+
+//R1.01 TRACING.
+//R1.01 Build with MAKO_TRACE=1 to turn it on. Every MAKO_TRACE_SCOPE records a begin/end time span for the
+//R1.01 code block it is in, tagged with the plugin instance and thread. Spans go into a lock free ring per
+//R1.01 thread and a background thread writes them to MakoTrace.json in the temp folder, or to the file
+//R1.01 named by the MAKO_TRACE_FILE environment variable. When off, everything here compiles to nothing.
+#ifndef MAKO_TRACE
+ #define MAKO_TRACE 0
+#endif
+
+#if MAKO_TRACE
+
+namespace MakoTrace
+{
+    //R1.01 One finished span. Name must be a string literal.
+    struct t_TraceEvent {
+        const char* Name;
+        const void* Instance;
+        juce::int64 Begin;
+        juce::int64 End;
+    };
+
+    //R1.01 Called by Scope. Audio thread safe, never allocates or locks.
+    void Push(const char* Name, const void* Instance, juce::int64 Begin, juce::int64 End) noexcept;
+
+    struct Scope
+    {
+        Scope(const char* N, const void* I) noexcept : Name(N), Instance(I), Begin(juce::Time::getHighResolutionTicks()) {}
+        ~Scope() noexcept { Push(Name, Instance, Begin, juce::Time::getHighResolutionTicks()); }
+
+        const char* Name;
+        const void* Instance;
+        juce::int64 Begin;
+    };
+
+    //R1.01 Writes the rings to the trace file. Hold one with juce::SharedResourcePointer<MakoTrace::Writer>
+    //R1.01 in each plugin instance. The file is closed when the last instance is deleted.
+    class Writer : public juce::Thread
+    {
+    public:
+        Writer();
+        ~Writer() override;
+        void run() override;
+
+    private:
+        std::unique_ptr<juce::FileOutputStream> Stream;
+        juce::int64 StartTicks = 0;
+        double TicksToUs = 1.0;
+        bool First = true;
+
+        void Drain();
+
+        JUCE_DECLARE_NON_COPYABLE(Writer)
+    };
+}
+
+ #define MAKO_TRACE_JOIN2(a, b) a##b
+ #define MAKO_TRACE_JOIN(a, b) MAKO_TRACE_JOIN2(a, b)
+ #define MAKO_TRACE_SCOPE(name)  MakoTrace::Scope MAKO_TRACE_JOIN(makoTraceScope, __LINE__) (name, this)
+
+#else
+
+ #define MAKO_TRACE_SCOPE(name)
+
+#endif
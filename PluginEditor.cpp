@@ -28,6 +28,8 @@ MakoBiteAudioProcessorEditor::MakoBiteAudioProcessorEditor (MakoBiteAudioProcess
     ParAtt[e_DMix] = std::make_unique <juce::AudioProcessorValueTreeState::SliderAttachment>(p.parameters,    "dmix",    sldKnob[e_DMix]);    
     
     ParAtt_Mono = std::make_unique <juce::AudioProcessorValueTreeState::SliderAttachment>(p.parameters, "mono", jsP1_Mono);
+    ParAtt_Midi = std::make_unique <juce::AudioProcessorValueTreeState::SliderAttachment>(p.parameters, "midi", jsP1_Midi);
+    ParAtt_Governor = std::make_unique <juce::AudioProcessorValueTreeState::SliderAttachment>(p.parameters, "governor", jsP1_Governor);
 
     imgLogo = juce::ImageCache::getFromMemory(BinaryData::makologobo_png, BinaryData::makologobo_pngSize);
 
@@ -53,7 +55,7 @@ MakoBiteAudioProcessorEditor::MakoBiteAudioProcessorEditor (MakoBiteAudioProcess
     //****************************************************************************************
     //R1.00 Large Rotary Slider
     GUI_Init_Large_Slider(&sldKnob[e_Gain],  audioProcessor.Setting[e_Gain],  0.0f,  10.0f, .025f,"", 2, 0xFFc0c0c0);
-    GUI_Init_Large_Slider(&sldKnob[e_Voice], audioProcessor.Setting[e_Voice],    0,  10.0,    1, "", 1, 0xFFFF8000);
+    GUI_Init_Large_Slider(&sldKnob[e_Voice], audioProcessor.Setting[e_Voice],    0,  11.0,    1, "", 1, 0xFFFF8000);
     GUI_Init_Large_Slider(&sldKnob[e_Gliss],  audioProcessor.Setting[e_Gliss],  0.0f, 1.0f, .01f, "", 1, 0xFFFF8000);
     GUI_Init_Large_Slider(&sldKnob[e_Mix],  audioProcessor.Setting[e_Mix],  0.0f, 1.0f, .01f, "", 2, 0xFFFF8000);
     GUI_Init_Large_Slider(&sldKnob[e_LP],   audioProcessor.Setting[e_LP],   50,  500, 25, " Hz", 3, 0xFFFF8000);
@@ -111,8 +113,24 @@ MakoBiteAudioProcessorEditor::MakoBiteAudioProcessorEditor (MakoBiteAudioProcess
     KNOB_DefinePosition(e_DLen,  430,  95, 100, 45, "Delay Repeat");
     KNOB_DefinePosition(e_DMix,  430, 170, 100, 45, "Delay Mix");
         
+    //R1.01 Sample voice file button.
+    butSample.setButtonText("Load WAV");
+    butSample.setColour(juce::TextButton::textColourOffId, juce::Colour(192, 192, 192));
+    butSample.onClick = [this] { butSampleClicked(); };
+    addAndMakeVisible(butSample);
+
     //R1.00 Setup the small option sliders.
     GUI_Init_Switch_Slider(&jsP1_Mono, audioProcessor.Pedal_Mono, 0, 1, 1, "");
+    GUI_Init_Switch_Slider(&jsP1_Midi, audioProcessor.Pedal_Midi, 0, 1, 1, "");
+    GUI_Init_Switch_Slider(&jsP1_Governor, audioProcessor.Pedal_Governor, 0, 1, 1, "");
+
+    //R1.01 Quality governor status. Updated a few times a second by our timer.
+    labQuality.setJustificationType(juce::Justification::centredLeft);
+    labQuality.setColour(juce::Label::backgroundColourId, juce::Colour(0x00000000));
+    labQuality.setColour(juce::Label::textColourId, juce::Colour(192, 192, 192));
+    addAndMakeVisible(labQuality);
+    timerCallback();
+    startTimerHz(4);
     
     //R1.00 Enable/Disable knobs based on VOICE setting.
     KNOB_SetVoiceEnable();
@@ -121,11 +139,14 @@ MakoBiteAudioProcessorEditor::MakoBiteAudioProcessorEditor (MakoBiteAudioProcess
     // editor's size to whatever you need it to be.
      
     //R1.00 Set the window size.
-    setSize(540, 250);
+    //R1.01 Taller to fit the MIDI Out switch.
+    //R1.01 And the Governor switch.
+    setSize(540, 330);
 }
 
 MakoBiteAudioProcessorEditor::~MakoBiteAudioProcessorEditor()
 {
+    stopTimer();
 }
 
 //==============================================================================
@@ -138,12 +159,12 @@ void MakoBiteAudioProcessorEditor::paint (juce::Graphics& g)
     ColGrad = juce::ColourGradient(juce::Colour(0xFF202030), 0.0f, 0.0f, juce::Colour(0xFF505060), 0.0f, 80.0f, false);
     g.setGradientFill(ColGrad);
     g.fillRect(0, 0, 540, 80);
-    ColGrad = juce::ColourGradient(juce::Colour(0xFF505060), 0.0f, 80.0f, juce::Colour(0xFF101020), 0.0f, 250.0f, false);
+    ColGrad = juce::ColourGradient(juce::Colour(0xFF505060), 0.0f, 80.0f, juce::Colour(0xFF101020), 0.0f, 330.0f, false);
     g.setGradientFill(ColGrad);
-    g.fillRect(0, 80, 540, 170);
+    g.fillRect(0, 80, 540, 250);
 
     g.setColour(juce::Colour(0x20000000));
-    g.fillRect(10, 2, 110, 210);
+    g.fillRect(10, 2, 110, 290);
 
     //R1.00 Headers.
     //g.setColour(juce::Colour(0xFF202030));
@@ -154,6 +175,8 @@ void MakoBiteAudioProcessorEditor::paint (juce::Graphics& g)
 
     g.setColour(juce::Colour(0xFFF0F0F0));
     g.drawFittedText("Stereo/Mono", 0, 175, 130, 15, juce::Justification::centred, 1);
+    g.drawFittedText("MIDI Out", 0, 215, 130, 15, juce::Justification::centred, 1);
+    g.drawFittedText("Governor", 0, 255, 130, 15, juce::Justification::centred, 1);
     
     //R1.00 Draw LOGO text.
     g.drawImageAt(imgLogo, 20, 5);
@@ -177,12 +200,20 @@ void MakoBiteAudioProcessorEditor::resized()
     
     //R1.00 Add some switches (Sliders).
     jsP1_Mono.setBounds     (20, 190, 80, 20);
+    jsP1_Midi.setBounds     (20, 230, 80, 20);
+    jsP1_Governor.setBounds (20, 270, 80, 20);
+
+    //R1.01 Quality governor status, next to its switch.
+    labQuality.setBounds (125, 271, 300, 18);
+
+    //R1.01 Sample voice file button.
+    butSample.setBounds (430, 232, 100, 20);
     
     //R1.00 Preset Dropdown List.
-    cbPreset.setBounds  (10, 220, 110, 18);    
+    cbPreset.setBounds  (10, 300, 110, 18);    
 
     //R1.00 Help Text / status bar.
-    labHelp.setBounds  (125, 220, 410, 18);    
+    labHelp.setBounds  (125, 300, 410, 18);    
 }
 
 void MakoBiteAudioProcessorEditor::cbPresetChanged()
@@ -203,8 +234,27 @@ void MakoBiteAudioProcessorEditor::cbPresetChanged()
         case 6:  Preset06(); break;   //R1.00 Clean Pad.    
     }
 
-    //R1.00 Flag the processor, we need to update settings.
-    audioProcessor.SettingsChanged = true;    
+    //R1.01 The sliders pass the preset to the APVTS. processBlock picks it up as parameter events.
+}
+
+void MakoBiteAudioProcessorEditor::butSampleClicked()
+{
+    //R1.01 Pick a single WAVE file (one cycle or one note) or a folder of WAVE files.
+    //R1.01 Folder files are named with their MIDI root note at the end. Bass_40.wav = E2.
+    labHelp.setText("Voice 11 plays a WAV file, or a folder of WAVs named with MIDI notes (Bass_40.wav).", juce::dontSendNotification);
+
+    SampleChooser = std::make_unique<juce::FileChooser>("Select a WAV file or a folder of WAV files", juce::File(), "*.wav");
+    auto Flags = juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles | juce::FileBrowserComponent::canSelectDirectories;
+
+    SampleChooser->launchAsync(Flags, [this](const juce::FileChooser& fc)
+    {
+        auto Result = fc.getResult();
+        if (Result == juce::File()) return;
+
+        //R1.01 The processor loads it on a background thread.
+        audioProcessor.SampleVoice_Load(Result);
+        labHelp.setText("Loading " + Result.getFileName(), juce::dontSendNotification);
+    });
 }
 
 void MakoBiteAudioProcessorEditor::cbPreset_UpdateSelection(int button, int idx, int editmode)
@@ -387,12 +437,15 @@ void MakoBiteAudioProcessorEditor::KNOB_SetVoiceEnable()
 
     if (int(sldKnob[e_Voice].getValue()) == 0) tMode = false;
 
+    //R1.01 MIDI Out still uses the pitch tracker settings when the synth is off.
+    bool tTrack = tMode || (0.5f < jsP1_Midi.getValue());
+
     //R1.00 Enable/Disable some SLIDERs.
-    sldKnob[e_Gliss].setEnabled(tMode);
+    sldKnob[e_Gliss].setEnabled(tTrack);
     sldKnob[e_Mix].setEnabled(tMode);
     sldKnob[e_Boost].setEnabled(tMode);
-    sldKnob[e_PreGain].setEnabled(tMode);
-    sldKnob[e_LP].setEnabled(tMode);    
+    sldKnob[e_PreGain].setEnabled(tTrack);
+    sldKnob[e_LP].setEnabled(tTrack);    
 }
 
 void MakoBiteAudioProcessorEditor::sliderValueChanged(juce::Slider* slider)
@@ -411,12 +464,8 @@ void MakoBiteAudioProcessorEditor::sliderValueChanged(juce::Slider* slider)
             //R1.00 Update HELP bar.
             labHelp.setText(HelpString[t], juce::dontSendNotification);
 
-            //R1.00 Update the actual processor variable being edited.
-            audioProcessor.Setting[t] = float(sldKnob[t].getValue());
-            
-            //R1.00 We need to update settings in processor.
-            //R1.00 Increment changed var to be sure every change gets made. Changed var is decremented in processor.
-            audioProcessor.SettingsChanged += 1; 
+            //R1.01 The slider attachment has already passed the new value to the APVTS. processBlock picks it
+            //R1.01 up as a parameter event, so it is sample accurate and goes into a capture like host automation.
 
             //R1.00 We have captured the correct slider change, exit this function.
             return;
@@ -430,7 +479,46 @@ void MakoBiteAudioProcessorEditor::sliderValueChanged(juce::Slider* slider)
         audioProcessor.Pedal_Mono = float(jsP1_Mono.getValue());
         return;
     }
+
+    //R1.01 MIDI Out.
+    if (slider == &jsP1_Midi)
+    {
+        labHelp.setText("Send the tracked pitch as MIDI notes. Voice 0 = MIDI only.", juce::dontSendNotification);
+        audioProcessor.Pedal_Midi = int(jsP1_Midi.getValue());
+        KNOB_SetVoiceEnable();
+        return;
+    }
+
+    //R1.01 Quality governor.
+    if (slider == &jsP1_Governor)
+    {
+        labHelp.setText("Trade some sound quality for CPU when the computer is too busy.", juce::dontSendNotification);
+        audioProcessor.Pedal_Governor = int(jsP1_Governor.getValue());
+        timerCallback();
+        return;
+    }
     
     return;
 }
 
+//R1.01 Show the quality level and DSP load the governor is working from. Text only changes when they do.
+void MakoBiteAudioProcessorEditor::timerCallback()
+{
+    int Level = audioProcessor.Governor_Level();
+    int Load = audioProcessor.Pedal_Governor ? juce::roundToInt(audioProcessor.Governor_Load() * 100.0f) : -1;
+    if ((Level == Quality_Shown) && (Load == Load_Shown)) return;
+    Quality_Shown = Level;
+    Load_Shown = Load;
+
+    //R1.01 Orange while we are running below full quality.
+    labQuality.setColour(juce::Label::textColourId, (Level == 0) ? juce::Colour(192, 192, 192) : juce::Colour(0xFFFF8000));
+
+    if (Load < 0)
+    {
+        labQuality.setText("Quality: Full (governor off)", juce::dontSendNotification);
+        return;
+    }
+
+    juce::String Text = "Quality: " + juce::String(MakoBiteAudioProcessor::Governor_Name(Level)) + "   DSP " + juce::String(Load) + "%";
+    labQuality.setText(Text, juce::dontSendNotification);
+}
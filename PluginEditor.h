@@ -31,10 +31,10 @@ public:
     int MakoSliderKnobStyle = 2;
     
 private:
-    //R1.00 Ten tick mark angles around a slider.
-    float TICK_Angle[11] = { 8.79645920, 8.29380417, 7.79114914, 7.28849411, 6.78583908, 6.28318405, 5.78052902, 5.27787399, 4.77521896, 4.27256393, 3.76 }; //3.76990914
-    float TICK_Cos[11] = {};
-    float TICK_Sin[11] = {};
+    //R1.01 Tick mark Sin/Cos values come from the tables shared by every instance.
+    juce::SharedResourcePointer<MakoSharedTables> Shared;
+    const float* TICK_Cos = Shared->TICK_Cos;
+    const float* TICK_Sin = Shared->TICK_Sin;
 
     juce::Image imgSwitchOn;
     juce::Image imgSwitchOff;
@@ -44,13 +44,6 @@ public:
     {
         imgSwitchOff = juce::ImageCache::getFromMemory(BinaryData::switchoff01_png, BinaryData::switchoff01_pngSize);
         imgSwitchOn = juce::ImageCache::getFromMemory(BinaryData::switchon01_png, BinaryData::switchon01_pngSize);
-
-        //R1.00 Do some PRECALC on Sin/Cos since they are expensive on CPU.
-        for (int t = 0; t < 11; t++)
-        {
-            TICK_Cos[t] = std::cosf(TICK_Angle[t]);
-            TICK_Sin[t] = std::sinf(TICK_Angle[t]);
-        }        
     }
 
     void drawLinearSlider(juce::Graphics& g, int x, int y, int width, int height, float sliderPos, float minSliderPos, float maxSliderPos, juce::Slider::SliderStyle, juce::Slider& sld) override
@@ -140,7 +133,7 @@ public:
 
 
 //R1.00 Add SLIDER listener. BUTTON or TIMER listeners also go here if needed. Must add ValueChanged overrides!
-class MakoBiteAudioProcessorEditor  : public juce::AudioProcessorEditor , public juce::Slider::Listener //, public juce::Button::Listener , public juce::Timer
+class MakoBiteAudioProcessorEditor  : public juce::AudioProcessorEditor , public juce::Slider::Listener , public juce::Timer //, public juce::Button::Listener
 {
 public:
     MakoBiteAudioProcessorEditor (MakoBiteAudioProcessor&);
@@ -148,6 +141,7 @@ public:
 
     //R1.00 OUR override functions.
     void sliderValueChanged(juce::Slider* slider) override;
+    void timerCallback() override;
 
     //==============================================================================
     void paint (juce::Graphics&) override;
@@ -183,6 +177,18 @@ private:
     int Knob_Cnt = 0;
     juce::Slider sldKnob[20];
     juce::Slider jsP1_Mono;
+    juce::Slider jsP1_Midi;
+    juce::Slider jsP1_Governor;
+
+    //R1.01 Quality level the governor has us at. Checked by our timer.
+    juce::Label labQuality;
+    int Quality_Shown = -1;
+    int Load_Shown = -1;
+
+    //R1.01 Load a WAVE file or folder for the SAMPLE voice (Voice 11).
+    juce::TextButton butSample;
+    std::unique_ptr<juce::FileChooser> SampleChooser;
+    void butSampleClicked();
     
     //R1.00 Define the coords and text for our knobs. Not JUCE related. 
     t_KnobCoors Knob_Pos[20] = {};
@@ -197,7 +203,7 @@ private:
     juce::String HelpString[20] =
     {
         "Adjust the volume for this effect.",
-        "Select 1 of 10 different synth sounds. 0=bypass. Neck pickup best.",
+        "Select 1 of 11 different synth sounds. 0=bypass. 11=WAV. Neck pickup best.",
         "Adjust Glissando(slide to pitch). Some helps avg pitch.",
         "Adjust mix between clean and synth signals.",
         "Low Pass. For low notes playing 100Hz is best. High notes 200 Hz.",
@@ -218,5 +224,7 @@ public:
     //R1.00 Define our SLIDER attachment variables.
     std::unique_ptr <juce::AudioProcessorValueTreeState::SliderAttachment> ParAtt[20];
     std::unique_ptr <juce::AudioProcessorValueTreeState::SliderAttachment> ParAtt_Mono;
+    std::unique_ptr <juce::AudioProcessorValueTreeState::SliderAttachment> ParAtt_Midi;
+    std::unique_ptr <juce::AudioProcessorValueTreeState::SliderAttachment> ParAtt_Governor;
 
 };
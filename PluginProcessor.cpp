@@ -8,6 +8,8 @@
 
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "MakoRTCheck.h"
+#include "MakoBounds.h"
 
 //==============================================================================
 MakoBiteAudioProcessor::MakoBiteAudioProcessor()
@@ -25,7 +27,7 @@ MakoBiteAudioProcessor::MakoBiteAudioProcessor()
     parameters(*this, nullptr, "PARAMETERS", 
       {
         std::make_unique<juce::AudioParameterFloat>("gain","Gain",         .0f, 10.0f, 1.0f),
-        std::make_unique<juce::AudioParameterInt>("voice","Voice",           0,   10, 1),
+        std::make_unique<juce::AudioParameterInt>("voice","Voice",           0,   11, 1),
         std::make_unique<juce::AudioParameterFloat>("gliss","Gliss",       .0f, 1.0f, .24f),
         std::make_unique<juce::AudioParameterFloat>("mix","Mix",           .0f, 1.0f, 1.0f),
         std::make_unique<juce::AudioParameterInt>("lp","Low Pass",          50,  500, 200),
@@ -38,16 +40,38 @@ MakoBiteAudioProcessor::MakoBiteAudioProcessor()
         std::make_unique<juce::AudioParameterFloat>("dmix","Delay Mix",   .0f, 1.0f, .1f),
 
         std::make_unique<juce::AudioParameterInt>("mono","Mono",    0, 1, 1),
+        std::make_unique<juce::AudioParameterInt>("midi","MIDI Out", 0, 1, 0),
+        std::make_unique<juce::AudioParameterInt>("governor","Governor", 0, 1, 0),
         
       }
     )   
 
 #endif
 {   
+    //R1.01 Store pointers to our parameter values. These are polled in processBlock for host automation.
+    //R1.01 The order here must match our e_ Settings enum.
+    const char* ParmID[PARM_Cnt] = { "gain", "voice", "gliss", "mix", "lp", "bal", "boost", "pregain", "attack", "dtime", "dlen", "dmix" };
+    for (int t = 0; t < PARM_Cnt; t++)
+    {
+        Parm_Raw[t] = parameters.getRawParameterValue(ParmID[t]);
+        Parm_Ptr[t] = parameters.getParameter(ParmID[t]);
+    }
+    Parm_RawMono = parameters.getRawParameterValue("mono");
+    Parm_RawMidi = parameters.getRawParameterValue("midi");
+    Parm_RawGovernor = parameters.getRawParameterValue("governor");
+
+    //R1.01 Our oscillator sine table does not depend on the sample rate. Every instance uses the same one.
+    SIN_Table = Shared->SIN_Table;
+
+    //R1.01 Best DSP kernels for this CPU. Picked once for the whole process.
+    Kern = MakoKernels_Select();
 }
 
 MakoBiteAudioProcessor::~MakoBiteAudioProcessor()
 {
+    //R1.01 Audio has stopped. Free the sample voice the audio thread was using.
+    SampleLoader.Release(Sample_Active);
+    Sample_Active = nullptr;
 }
 
 //==============================================================================
@@ -85,7 +109,18 @@ bool MakoBiteAudioProcessor::isMidiEffect() const
 
 double MakoBiteAudioProcessor::getTailLengthSeconds() const
 {
-    return 0.0;
+    //R1.01 The delay keeps ringing after the input stops. Report how long until it is down 60 dB.
+    if (Setting[e_DMix] < .001f) return 0.0;
+
+    //R1.01 Longest echo. Delay Time * 2 * Ratio, and ratios are never above 1.0.
+    double Echo = 2.0 * Setting[e_DTime];
+
+    //R1.01 Each repeat is Del Repeat times the last one. Cap it for settings that ring forever.
+    if (.999f <= Setting[e_DLen]) return 60.0;
+    double Repeats = 1.0;
+    if (.001f < Setting[e_DLen]) Repeats = ceil(log(.001) / log(double(Setting[e_DLen])));
+
+    return juce::jmin(60.0, Echo * (Repeats + 1.0));
 }
 
 int MakoBiteAudioProcessor::getNumPrograms()
@@ -120,19 +155,72 @@ void MakoBiteAudioProcessor::prepareToPlay (double sampleRate, int samplesPerBlo
 
 
     //R1.00 Get our Sample Rate for filter calculations.
-    SampleRate = MakoBiteAudioProcessor::getSampleRate();
-    if (SampleRate < 21000) SampleRate = 48000;
-    if (192000 < SampleRate) SampleRate = 48000;
+    //R1.01 High host rates are halved until they fit under INTERNAL_MaxRate. Everything below runs at that rate.
+    double HostRate = MakoBiteAudioProcessor::getSampleRate();
+    if (HostRate < 21000) HostRate = 48000;
+    Rate_Shift = 0;
+    while ((INTERNAL_MaxRate < HostRate / double(1 << Rate_Shift)) && (Rate_Shift < MakoResampler::MAX_Stages)) Rate_Shift++;
+    SampleRate = float(HostRate / double(1 << Rate_Shift));
+
+    //R1.01 Calculate every filter setting for this sample rate.
+    Filter_BuildTables();
+
+    //R1.01 Size all of our per channel state for the channel count the host gave us.
+    Channels_Resize(juce::jmax(getTotalNumInputChannels(), getTotalNumOutputChannels()));
+    Bypass_Dry.setSize(Chan_Cnt, BYPASS_Fade);
+
+    //R1.01 Resampler and the internal rate buffer. Hosts can send blocks bigger than they said so we work in chunks.
+    Rate_Chunk = juce::jmax(samplesPerBlock, int(INTERNAL_MinChunk));
+    Resampler.Prepare(Chan_Cnt, Rate_Shift, Rate_Chunk);
+    Rate_Buffer.setSize(Chan_Cnt, (Rate_Chunk >> Rate_Shift) + 2);
+    setLatencySamples(Resampler.Latency());
+
+    //R1.01 Governor windows are in host samples. Every session starts at full quality.
+    Gov_HostRate = HostRate;
+    Gov_TickRate = double(juce::Time::getHighResolutionTicksPerSecond());
+    Gov_WindowLen = juce::jmax(1, int(HostRate * GOV_Window_ms * .001));
+    Gov_Ticks = 0;
+    Gov_Samples = 0;
+    Gov_Calm = 0;
+    Gov_Load = 0.0f;
+    Governor_Apply(e_Gov_Full);
+
+    //R1.01 Playback starts from a known state so a capture can be replayed exactly.
+    Segment_Clock = 0;
+    Parm_EventCnt = 0;
+    Settings_Force = false;
+    Bypass_FadeCnt = 0;
+    Midi_Note = -1;
+    Midi_Bend = 8192;
+    Midi_NewNoteCnt = 0;
+    Midi_Work.ensureSize(size_t(MIDI_ReserveBytes));
+    Delay_Run = false;
         
     //R1.00 Update things that need updating as the program is running normally.
     //R1.00 Force every setting to be calculated.
     Settings_Update(true);    
+
+    //R1.01 Start a capture if one was asked for.
+    if (!Replay_On)
+    {
+        juce::File RecFile = Record_File;
+        juce::String RecDir = juce::SystemStats::getEnvironmentVariable("MAKO_RECORD", {});
+        if ((RecFile == juce::File()) && RecDir.isNotEmpty())
+            RecFile = juce::File::getCurrentWorkingDirectory().getChildFile(RecDir)
+                          .getChildFile("MakoCapture_" + juce::Time::getCurrentTime().formatted("%Y%m%d_%H%M%S") + ".mkr");
+
+        Record_File = juce::File();
+        if ((RecFile != juce::File()) && Recorder.Start(RecFile)) Record_Header(samplesPerBlock);
+    }
 }
 
 void MakoBiteAudioProcessor::releaseResources()
 {
     // When playback stops, you can use this as an opportunity to free up any
     // spare memory, etc.
+
+    //R1.01 Close any capture file.
+    Recorder.Stop();
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -143,11 +231,8 @@ bool MakoBiteAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts)
     return true;
   #else
     // This is the place where you check if the layout is supported.
-    // In this template code we only support mono or stereo.
-    // Some plugin hosts, such as certain GarageBand versions, will only
-    // load plugins that support stereo bus layouts.
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-     && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    //R1.01 Any channel count is supported. Our state is sized in prepareToPlay.
+    if (layouts.getMainOutputChannelSet().isDisabled())
         return false;
 
     // This checks if the input layout matches the output layout
@@ -164,16 +249,185 @@ bool MakoBiteAudioProcessor::isBusesLayoutSupported (const BusesLayout& layouts)
 void MakoBiteAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
     juce::ScopedNoDenormals noDenormals;
+    MAKO_RTCHECK_AUDIO_SCOPE;     //R1.01 Debug builds with MAKO_RTCHECK=1 stop on any allocation from here on.
+    MAKO_TRACE_SCOPE("processBlock");
+
+    //R1.01 Pick up any host automation as parameter events at the start of this block.
+    //R1.01 When replaying a capture the events were already loaded by Replay_Block.
+    if (!Replay_On) Parm_PollHost();
+    Record_Block(buffer, MakoRecorder::e_Rec_Block);
+
+    //R1.01 Time our work for the quality governor. Ticks are only read when it is switched on.
+    juce::int64 Gov_Start = Pedal_Governor ? juce::Time::getHighResolutionTicks() : 0;
+    Midi_Work.clear();
+    Mako_Rate(buffer, Midi_Work, false);
+    Midi_Flush(midiMessages);
+    Governor_Update(Gov_Start, buffer.getNumSamples());
+}
+
+void MakoBiteAudioProcessor::processBlockBypassed (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    juce::ScopedNoDenormals noDenormals;
+    MAKO_RTCHECK_AUDIO_SCOPE;
+    MAKO_TRACE_SCOPE("processBlockBypassed");
+
+    if (!Replay_On) Parm_PollHost();
+    Record_Block(buffer, MakoRecorder::e_Rec_Bypassed);
+
+    Midi_Work.clear();
+    Mako_Rate(buffer, Midi_Work, true);
+    Midi_Flush(midiMessages);
+
+    //R1.01 Pure passthrough from here. The buffer already holds the dry signal.
+    for (auto i = getTotalNumInputChannels(); i < getTotalNumOutputChannels(); ++i)
+        buffer.clear (i, 0, buffer.getNumSamples());
+}
+
+//R1.01 Run the host block at our internal rate. At normal host rates this is just Mako_Run.
+void MakoBiteAudioProcessor::Mako_Rate(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages, bool Bypassed)
+{
+    int numSamples = buffer.getNumSamples();
+    Midi_Base = 0;
+    Midi_Last = juce::jmax(0, numSamples - 1);
+
+    if (Rate_Shift == 0)
+    {
+        Mako_Run(buffer, midiMessages, Bypassed);
+        return;
+    }
+
+    //R1.01 Parameter events move to internal rate offsets. Events past the first chunk are
+    //R1.01 applied at the start of the next one by Parm_Defer.
+    for (int ev = 0; ev < Parm_EventCnt; ev++) Parm_Events[ev].offset >>= Rate_Shift;
+
+    //R1.01 Bypassed audio goes through the resampler too so the dry signal has the same latency as our sound.
+    for (int start = 0; start < numSamples; start += Rate_Chunk)
+    {
+        int num = juce::jmin(Rate_Chunk, numSamples - start);
+        juce::AudioBuffer<float> Host(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), start, num);
+
+        MAKO_BOUNDS(start, num, numSamples, "Rate host chunk");
+        int numInternal = Resampler.Down(Host, num, Rate_Buffer);
+        MAKO_BOUNDS(0, numInternal, Rate_Buffer.getNumSamples(), "Rate_Buffer");
+        juce::AudioBuffer<float> Internal(Rate_Buffer.getArrayOfWritePointers(), Rate_Buffer.getNumChannels(), numInternal);
+
+        Midi_Base = start;
+        Midi_Last = start + num - 1;
+        Mako_Run(Internal, midiMessages, Bypassed);
+
+        Resampler.Up(Internal, numInternal, Host, num);
+    }
+}
+
+//R1.01 Our processing at the internal rate with the bypass crossfades.
+void MakoBiteAudioProcessor::Mako_Run(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages, bool Bypassed)
+{
+    if (!Bypassed)
+    {
+        //R1.01 Coming back from host bypass. Old echoes and tracking are cleared and our sound fades back in.
+        //R1.01 If a fade out was still running we fade in from the level it had reached.
+        if (Bypass_On)
+        {
+            Bypass_On = false;
+            Bypass_FadeCnt = BYPASS_Fade - Bypass_FadeCnt;
+            Delay_Clear();
+            for (int t = 0; t < Chan_Cnt; t++)
+            {
+                Chan_State[t].Attack_Run = 0;
+                Chan_State[t].Track_Run = 0;
+            }
+        }
+
+        if (Bypass_FadeCnt <= 0)
+        {
+            Mako_ProcessBlock(buffer, midiMessages);
+            return;
+        }
+
+        int num = juce::jmin(Bypass_FadeCnt, buffer.getNumSamples());
+        Bypass_CopyDry(buffer, num);
+        Mako_ProcessBlock(buffer, midiMessages);
+        Bypass_Mix(buffer, num, true);
+        return;
+    }
+
+    //R1.01 Just bypassed. Fade out from our sound, or from the level a fade in had reached.
+    if (!Bypass_On)
+    {
+        Bypass_On = true;
+        Bypass_FadeCnt = BYPASS_Fade - Bypass_FadeCnt;
+    }
+
+    //R1.01 Keep processing only the samples that are still fading.
+    if (0 < Bypass_FadeCnt)
+    {
+        int num = juce::jmin(Bypass_FadeCnt, buffer.getNumSamples());
+        Bypass_CopyDry(buffer, num);
+
+        juce::AudioBuffer<float> Head(buffer.getArrayOfWritePointers(), buffer.getNumChannels(), num);
+        Mako_ProcessBlock(Head, midiMessages);
+        Bypass_Mix(buffer, num, false);
+
+        //R1.01 Fade is done. End any MIDI note we were holding.
+        if (Bypass_FadeCnt <= 0)
+        {
+            Midi_Out = &midiMessages;
+            Midi_NoteOff(Midi_HostOffset(juce::jmax(0, num - 1)));
+            Midi_Out = nullptr;
+        }
+    }
+
+    //R1.01 Parameter changes are not used while bypassed. Keep them for when we come back.
+    Parm_Defer(0);
+}
+
+//R1.01 Save the dry signal for the samples we are about to crossfade.
+void MakoBiteAudioProcessor::Bypass_CopyDry(const juce::AudioBuffer<float>& buffer, int num)
+{
+    int Chans = juce::jmin(buffer.getNumChannels(), Bypass_Dry.getNumChannels());
+    MAKO_BOUNDS(0, num, Bypass_Dry.getNumSamples(), "Bypass_Dry");
+    MAKO_BOUNDS(0, num, buffer.getNumSamples(), "Bypass buffer");
+    for (int t = 0; t < Chans; t++) Bypass_Dry.copyFrom(t, 0, buffer, t, 0, num);
+}
+
+//R1.01 Crossfade the processed buffer with the saved dry signal. Bypass_FadeCnt counts down to 0 across calls.
+void MakoBiteAudioProcessor::Bypass_Mix(juce::AudioBuffer<float>& buffer, int num, bool FadeIn)
+{
+    int Chans = juce::jmin(buffer.getNumChannels(), Bypass_Dry.getNumChannels());
+    float Div = 1.0f / BYPASS_Fade;
+
+    for (int ch = 0; ch < Chans; ch++)
+    {
+        float* Dest = buffer.getWritePointer(ch);
+        const float* Dry = Bypass_Dry.getReadPointer(ch);
+        for (int t = 0; t < num; t++)
+        {
+            //R1.01 Wet volume. Fades from 1 to 0 going into bypass, 0 to 1 coming out.
+            float Wet = float(Bypass_FadeCnt - t) * Div;
+            if (FadeIn) Wet = 1.0f - Wet;
+            Dest[t] = Dry[t] + (Dest[t] - Dry[t]) * Wet;
+        }
+    }
+
+    Bypass_FadeCnt -= num;
+}
+
+void MakoBiteAudioProcessor::Mako_ProcessBlock (juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
     auto totalNumInputChannels  = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
 
-    //R1.00 Our defined variables.
-    float tS;  //R1.00 Temporary Sample.
-    float tSOrg;
+    //R1.01 Pick up a newly loaded sample voice. Lock free, the old one is freed by the loader thread.
+    MakoSampleSet* NewSet = SampleLoader.Acquire(Sample_Active);
+    if (NewSet != Sample_Active)
+    {
+        Sample_Active = NewSet;
+        for (int t = 0; t < Chan_Cnt; t++) Chan_State[t].Sample_Zone = -1;
+    }
 
-    //R1.00 Handle any changes to our Parameters in the Editor. 
-    //R1.00 Dont force all updates. Just change things that have changed since last check.
-    if (0 < SettingsChanged) Settings_Update(false);
+    //R1.01 MIDI messages we create go into Midi_Work. Midi_Flush adds them to the host buffer.
+    Midi_Out = &midiMessages;
+    if (!Pedal_Midi && (0 <= Midi_Note)) Midi_NoteOff(Midi_HostOffset(0));
 
     // In case we have more outputs than inputs, this code clears any output
     // channels that didn't contain input data, (because these aren't
@@ -184,6 +438,80 @@ void MakoBiteAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juc
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear (i, 0, buffer.getNumSamples());
 
+    //R1.01 Split the buffer into segments at every parameter event and at every SEGMENT_Size grid point.
+    //R1.01 The grid is based on the total samples processed, not the block start, so renders match at any block size.
+    int numSamples = buffer.getNumSamples();
+    int samp = 0;
+    int ev = 0;
+    while (samp < numSamples)
+    {
+        //R1.01 Apply every event that lands on this sample.
+        bool Changed = false;
+        while ((ev < Parm_EventCnt) && (Parm_Events[ev].offset <= samp))
+        {
+            Parm_Apply(Parm_Events[ev].idx, Parm_Events[ev].value);
+            Changed = true;
+            ev++;
+        }
+
+        //R1.00 Handle any changes to our Parameters in the Editor. 
+        //R1.00 Dont force all updates. Just change things that have changed since last check.
+        //R1.01 A state load asks for everything to be recalculated, once, after its events are applied.
+        if (Settings_Force)
+        {
+            Settings_Update(true);
+            Settings_Force = false;
+        }
+        else if (Changed || (0 < SettingsChanged)) Settings_Update(false);
+
+        //R1.01 Find the end of this segment. Next grid point, next event, or end of buffer.
+        int segEnd = samp + SEGMENT_Size - int(Segment_Clock % SEGMENT_Size);
+        if (numSamples < segEnd) segEnd = numSamples;
+        if ((ev < Parm_EventCnt) && (Parm_Events[ev].offset < segEnd)) segEnd = Parm_Events[ev].offset;
+
+        //R1.01 Glide any filter coefficient changes.
+        for (int t = 0; t < ANALYSIS_LPStages; t++) Filter_RampStep(&makoF_HiCut[t]);
+
+        Mako_ProcessSegment(buffer, samp, segEnd - samp);
+
+        Segment_Clock += segEnd - samp;
+        samp = segEnd;
+    }
+
+    //R1.01 Events past the end of the block still need to be kept. They take effect next block.
+    Parm_Defer(ev);
+    Midi_Out = nullptr;
+}
+
+//R1.01 Apply queued events from ev on as plain setting changes and empty the queue.
+void MakoBiteAudioProcessor::Parm_Defer(int ev)
+{
+    //R1.01 One update picks up every changed setting, so a burst of events only asks for one.
+    bool Deferred = (ev < Parm_EventCnt);
+    for (; ev < Parm_EventCnt; ev++) Parm_Apply(Parm_Events[ev].idx, Parm_Events[ev].value);
+    if (Deferred && (SettingsChanged <= 0)) SettingsChanged += 1;
+
+    //R1.01 All events for this block have been used.
+    Parm_EventCnt = 0;
+}
+
+void MakoBiteAudioProcessor::Mako_ProcessSegment(juce::AudioBuffer<float>& buffer, int start, int num)
+{
+    MAKO_TRACE_SCOPE("Segment");
+
+    //R1.01 Never run more channels than we have state for.
+    auto totalNumInputChannels = juce::jmin(getTotalNumInputChannels(), Chan_Cnt);
+
+    //R1.00 Our defined variables.
+    float tS;  //R1.00 Temporary Sample.
+    float Attacked[SEGMENT_Size];  //R1.01 Segment after the ATTACK envelope.
+    float Analysis[SEGMENT_Size];  //R1.01 Segment after the pitch analysis filters.
+    float Synth[SEGMENT_Size];     //R1.01 Segment of synth sound.
+
+    jassert(num <= SEGMENT_Size);
+    MAKO_BOUNDS(0, num, SEGMENT_Size, "Segment work buffers");
+    MAKO_BOUNDS(start, num, buffer.getNumSamples(), "Segment");
+
     // This is the place where you'd normally do the guts of your plugin's
     // audio processing...
     // Make sure to reset the state if your inner loop is processing
@@ -197,40 +525,108 @@ void MakoBiteAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juc
         //*********************************************************
         //R1.00 Process the AUDIO buffer data. Apply our effects.
         //*********************************************************
-        if (Pedal_Mono && (channel == 1))
+        if (Pedal_Mono && (0 < channel))
         {
             auto* channel0Data = buffer.getWritePointer(0);
 
             //R1.0 FORCE MONO - Put CHANNEL 0 data in CHANNEL 1.
-            for (int samp = 0; samp < buffer.getNumSamples(); samp++) channelData[samp] = channel0Data[samp];
+            //R1.01 And every other channel after it.
+            Kern->Copy(channelData + start, channel0Data + start, num);
         }
         else
         {
-            // ..do something to the data...
-            for (int samp = 0; samp < buffer.getNumSamples(); samp++)
+            tp_chanstate& cs = Chan_State[channel];
+
+            //R1.01 Work out which stages this segment needs. Sections that are turned off are skipped.
+            bool MixOn = (.001f <= Setting[e_Mix]);
+            bool SynthOn = MixOn && (int(Setting[e_Voice]) != 0);
+            bool TrackOn = SynthOn || (Pedal_Midi && (channel == 0));
+            bool AttackOn = MixOn || TrackOn;
+
+            //R1.01 A stage coming back on starts from silence, not from whatever it held when it stopped.
+            if (AttackOn && !cs.Attack_Run)
             {
-                //R1.00 Get the current sample and put it in tS. 
-                tS = buffer.getSample(channel, samp);
-                tSOrg = tS;
+                cs.Signal_VolFade = 0.0f;
+                cs.Signal_AVG = 0.0f;
+                cs.Signal_VolFadeOn = 0;
+            }
+            if (TrackOn && !cs.Track_Run)
+            {
+                cs.Mod_PitchCnt = 0;
+                cs.Mod_Peak = 0.0f;
+                cs.Mod_LastSample = 0.0f;
+                for (int t = 0; t < FILT_Cnt; t++) cs.Filt[t] = {};
+            }
+            cs.Attack_Run = AttackOn;
+            cs.Track_Run = TrackOn;
 
-                //R1.00 Apply the ATTACK effect.
-                tS = Mako_FX_Attack(tS, channel);
+           #if MAKO_REFERENCE_CHECK
+            //R1.01 Reference builds can run the whole channel through the frozen scalar code instead.
+            if (Ref_On)
+            {
+                Ref_Segment(channelData, start, num, channel, AttackOn, TrackOn, SynthOn);
+                continue;
+            }
+           #endif
 
-                //R1.00 Calc pitch and create the synth sound.
-                tS = Mako_FX_MonoToneSyn(tS, channel);
-               
-                //R1.00 Mix original sample and new modified synth sample. 
-                tS = (tSOrg * (1.0f - Setting[e_Mix])) + (tS * Setting[e_Mix]);
+            //R1.00 Apply the ATTACK effect.
+            //R1.01 Done for the whole segment at once.
+            if (AttackOn)
+            {
+                MAKO_TRACE_SCOPE("Attack");
+                Mako_FX_Attack(channelData + start, Attacked, num, channel);
+            }
 
+            if (TrackOn)
+            {
+                //R1.01 Filter the segment for the pitch detector.
+                {
+                    MAKO_TRACE_SCOPE("Analysis Filters");
+                    Filter_Analysis_Block(Attacked, Analysis, num, channel);
+                }
+
+                MAKO_TRACE_SCOPE("Synth + Delay");
+
+                // ..do something to the data...
+                for (int samp = start; samp < start + num; samp++)
+                {
+                    //R1.00 Get the current sample and put it in tS. 
+                    tS = Attacked[samp - start];
+                    Midi_Offset = Midi_HostOffset(samp);
+
+                    //R1.00 Calc pitch and create the synth sound.
+                    tS = Mako_FX_MonoToneSyn(tS, Analysis[samp - start], channel);
+                    Synth[samp - start] = tS;
+                }
+
+                //R1.00 Apply BOOST if selected, and BALANCE.
+                if (SynthOn) Mako_FX_Boost(Synth, num, channel);
+
+                //R1.00 Mix original sample and new modified synth sample. 
                 //R1.00 Reduce vol.We dont want to exceed - 1 / 1.
                 //R1.00 If tSOrg = 1 and tS = 1 that = 2. Which is bad.
-                tS = tS * .5f;
+                Kern->Mix_Half(channelData + start, Synth, num, Setting[e_Mix]);
 
                 //R1.00 Add stereo Digital Delay. 
-                tS = Mako_FX_Delay(tS, channel);
-
                 //R1.00 Write our modified sample back into the sample buffer.
-                channelData[samp] = tS * Setting[e_Gain];
+                Mako_FX_Delay_Block(channelData + start, num, channel);
+                Kern->Scale(channelData + start, num, Setting[e_Gain]);
+            }
+            else
+            {
+                //R1.01 FAST PATH. No synth and no pitch tracking. Same math as the full loop with the synth
+                //R1.01 returning the attacked signal, done one stage at a time across the segment.
+                MAKO_TRACE_SCOPE("Mix + Delay");
+                float* Dest = channelData + start;
+                if (MixOn)
+                    Kern->Mix_Half(Dest, Attacked, num, Setting[e_Mix]);
+                else
+                    Kern->Scale(Dest, num, .5f);
+
+                if (Delay_Run)
+                    Mako_FX_Delay_Block(Dest, num, channel);
+
+                Kern->Scale(Dest, num, Setting[e_Gain]);
             }
         }
         //**************************************************
@@ -238,6 +634,94 @@ void MakoBiteAudioProcessor::processBlock (juce::AudioBuffer<float>& buffer, juc
     }
 }
 
+void MakoBiteAudioProcessor::Parm_QueueEvent(int offset, int idx, float value)
+{
+    //R1.01 Add a parameter change at a sample offset in the current block. Keep the list sorted by offset.
+    //R1.01 Past PARMEVENT_Max events, a change to an idx that already has one replaces its latest event
+    //R1.01 (new value, at the later offset) instead of taking another slot. Each idx can then add at most
+    //R1.01 one event past PARMEVENT_Max, and the queue has room for that, so no change is ever lost.
+    if ((idx < 0) || (PARM_Ratio + Chan_Cnt <= idx)) return;
+    if (offset < 0) offset = 0;
+
+    if (PARMEVENT_Max <= Parm_EventCnt)
+    {
+        for (int ev = Parm_EventCnt - 1; 0 <= ev; ev--)
+        {
+            if (Parm_Events[ev].idx != idx) continue;
+            if (offset < Parm_Events[ev].offset) offset = Parm_Events[ev].offset;
+            for (; ev < Parm_EventCnt - 1; ev++) Parm_Events[ev] = Parm_Events[ev + 1];
+            Parm_EventCnt--;
+            break;
+        }
+    }
+
+    //R1.01 Full only before prepareToPlay has sized the queue.
+    if (int(Parm_Events.size()) <= Parm_EventCnt) return;
+    int pos = Parm_EventCnt++;
+
+    //R1.01 Slide later events up to make room. Events at the same offset stay in arrival order.
+    while ((0 < pos) && (offset < Parm_Events[pos - 1].offset))
+    {
+        Parm_Events[pos] = Parm_Events[pos - 1];
+        pos--;
+    }
+
+    Parm_Events[pos].offset = offset;
+    Parm_Events[pos].idx = idx;
+    Parm_Events[pos].value = value;
+}
+
+//R1.01 Apply one event. Indexes we have nothing for (a damaged capture) are ignored.
+void MakoBiteAudioProcessor::Parm_Apply(int idx, float value)
+{
+    if ((0 <= idx) && (idx < PARM_Cnt))
+    {
+        Setting[idx] = value;
+        return;
+    }
+
+    //R1.01 A channel's delay ratio. Clearing Setting_Last makes Settings_Update recalculate the delay lengths.
+    int ch = idx - PARM_Ratio;
+    if ((0 <= ch) && (ch < Chan_Cnt))
+    {
+        Delay_Ratio[ch] = value;
+        Setting_Last[e_DTime] = -1.0f;
+    }
+}
+
+void MakoBiteAudioProcessor::Parm_PollHost()
+{
+    //R1.01 Host automation arrives through the APVTS. Turn any value that differs from our
+    //R1.01 settings into an event at the start of the block.
+    for (int t = 0; t < PARM_Cnt; t++)
+    {
+        if (Parm_Raw[t] == nullptr) continue;
+
+        //R1.01 Parameters that already have events this block (CLAP) have their own sample offsets.
+        bool Queued = false;
+        for (int ev = 0; ev < Parm_EventCnt; ev++)
+            if (Parm_Events[ev].idx == t) Queued = true;
+        if (Queued) continue;
+
+        float v = Parm_Raw[t]->load();
+        if (v != Setting[t]) Parm_QueueEvent(0, t, v);
+    }
+
+    //R1.01 Delay ratios set from other threads become events too, so a capture has them.
+    for (int t = 0; t < Chan_Cnt; t++)
+    {
+        if (Delay_RatioReq[t].load() <= 0.0f) continue;
+        Parm_QueueEvent(0, PARM_Ratio + t, Delay_RatioReq[t].exchange(0.0f));
+    }
+
+    if (Parm_RawMono != nullptr) Pedal_Mono = int(Parm_RawMono->load());
+    if (Parm_RawMidi != nullptr) Pedal_Midi = int(Parm_RawMidi->load());
+    if (Parm_RawGovernor != nullptr) Pedal_Governor = int(Parm_RawGovernor->load());
+
+    //R1.01 A full update asked for by setStateInformation. Kept until a block processes it.
+    if (Settings_ForceReq.exchange(false)) Settings_Force = true;
+}
+
 //==============================================================================
 bool MakoBiteAudioProcessor::hasEditor() const
 {
@@ -275,25 +759,46 @@ void MakoBiteAudioProcessor::setStateInformation (const void* data, int sizeInBy
         if (xmlState->hasTagName(parameters.state.getType()))
             parameters.replaceState(juce::ValueTree::fromXml(*xmlState));
 
-    //R1.00 Get our parameters from the new settings.
-    Setting[e_Gain] = makoGetParmValue_float("gain");
-    Setting[e_Voice] = makoGetParmValue_int("voice");
-    Setting[e_Gliss] = makoGetParmValue_float("gliss");
-    Setting[e_Mix] = makoGetParmValue_float("mix");
-    Setting[e_LP] = makoGetParmValue_int("lp");    
-    Setting[e_Bal] = makoGetParmValue_float("bal");
-    Setting[e_Boost] = makoGetParmValue_float("boost");
-    Setting[e_PreGain] = makoGetParmValue_float("pregain");
-    Setting[e_Attack] = makoGetParmValue_float("attack");
-    Setting[e_DTime] = makoGetParmValue_float("dtime");
-    Setting[e_DLen] = makoGetParmValue_float("dlen");
-    Setting[e_DMix] = makoGetParmValue_float("dmix");    
-    
-    Pedal_Mono = makoGetParmValue_int("mono");
-    
+    //R1.01 Reload the sample voice that was saved with this state.
+    juce::String SamplePath = parameters.state.getProperty("samplepath").toString();
+    if (SamplePath.isNotEmpty()) SampleLoader.Request(juce::File(SamplePath));
+
     //R1.00 Force all settings to be updated.
-    Settings_Update(true);
+    //R1.01 Not here, we are on the message thread. Parm_PollHost turns the new APVTS values into events
+    //R1.01 and the audio thread does the full update, so a capture has both and replays them.
+    Settings_ForceReq = true;
+}
+
+#if MAKO_CLAP
+bool MakoBiteAudioProcessor::supportsDirectEvent(uint16_t space_id, uint16_t type)
+{
+    //R1.01 We only take parameter value changes. Everything else goes through the normal JUCE path.
+    return (space_id == CLAP_CORE_EVENT_SPACE_ID) && (type == CLAP_EVENT_PARAM_VALUE);
+}
+
+void MakoBiteAudioProcessor::handleDirectEvent(const clap_event_header_t* event, int sampleOffset)
+{
+    //R1.01 Called on the audio thread before processBlock, once for each event in the block.
+    if ((event->space_id != CLAP_CORE_EVENT_SPACE_ID) || (event->type != CLAP_EVENT_PARAM_VALUE)) return;
+
+    auto* pev = reinterpret_cast<const clap_event_param_value_t*>(event);
+    auto* Parm = static_cast<juce::AudioProcessorParameter*>(pev->cookie);
+
+    for (int t = 0; t < PARM_Cnt; t++)
+    {
+        if ((Parm_Ptr[t] == nullptr) || (Parm != Parm_Ptr[t])) continue;
+
+        //R1.01 CLAP values are JUCE normalized values. Our event queue splits the block at the real sample offset.
+        //R1.01 The APVTS raw value Parm_PollHost reads is only updated by the parameter listeners, so they are
+        //R1.01 told too (the JUCE VST3 wrapper does the same). Otherwise the next poll would undo this change.
+        float Norm = float(pev->value);
+        Parm_Ptr[t]->setValue(Norm);
+        Parm_Ptr[t]->sendValueChangedMessageToListeners(Norm);
+        Parm_QueueEvent(sampleOffset, t, Parm_Ptr[t]->convertFrom0to1(Norm));
+        return;
+    }
 }
+#endif
 
 int MakoBiteAudioProcessor::makoGetParmValue_int(juce::String Pstring)
 {
@@ -324,59 +829,142 @@ juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
 }
 
 //R1.00 Actual filter calculation code that modifies our sample.
-float MakoBiteAudioProcessor::Filter_Calc_BiQuad(float tSample, int channel, tp_filter* fn)
+float MakoBiteAudioProcessor::Filter_Calc_BiQuad(float tSample, tp_filterhist* hist, tp_filter* fn)
 {
     float tS = tSample;
 
-    fn->xn0[channel] = tS;
-    tS = fn->a0 * fn->xn0[channel] + fn->a1 * fn->xn1[channel] + fn->a2 * fn->xn2[channel] - fn->b1 * fn->yn1[channel] - fn->b2 * fn->yn2[channel];
-    fn->xn2[channel] = fn->xn1[channel]; fn->xn1[channel] = fn->xn0[channel]; fn->yn2[channel] = fn->yn1[channel]; fn->yn1[channel] = tS;
+    tS = fn->a0 * tSample + fn->a1 * hist->xn1 + fn->a2 * hist->xn2 - fn->b1 * hist->yn1 - fn->b2 * hist->yn2;
+    hist->xn2 = hist->xn1; hist->xn1 = tSample; hist->yn2 = hist->yn1; hist->yn1 = tS;
 
     return tS;
 }
 
+//R1.01 The pitch analysis chain for one segment. Every stage is run per sample with its history held
+//R1.01 in local variables, so there is one function call per segment instead of one per stage per sample.
+void MakoBiteAudioProcessor::Filter_Analysis_Block(const float* Src, float* Dest, int num, int channel)
+{
+    //R1.01 Chain = LoCut, HiCut stages, then the optional Emphasis. Slot is each stage's FILT_ history slot,
+    //R1.01 so the Emphasis keeps its own history when the governor runs fewer HiCut stages.
+    const int Stages = Analysis_LPRun + (ANALYSIS_Emphasis ? 2 : 1);
+    tp_filterhist* Hist = Chan_State[channel].Filt;
+    tp_filter* Chain[FILT_Cnt];
+    int Slot[FILT_Cnt];
+    int s = 0;
+    Chain[s] = &makoF_LoCut; Slot[s++] = FILT_LoCut;
+    for (int t = 0; t < Analysis_LPRun; t++) { Chain[s] = &makoF_HiCut[t]; Slot[s++] = FILT_HiCut + t; }
+    if (ANALYSIS_Emphasis) { Chain[s] = &makoF_Emph; Slot[s++] = FILT_Emph; }
+
+    //R1.01 Gather coefficients and history for the kernel.
+    static_assert(FILT_Cnt <= KERN_MaxStages, "Analysis chain is longer than the biquad kernel allows");
+    float Coef[FILT_Cnt][5];
+    float H[FILT_Cnt][4];
+    for (int st = 0; st < Stages; st++)
+    {
+        tp_filter* fn = Chain[st];
+        tp_filterhist& h = Hist[Slot[st]];
+        Coef[st][0] = fn->a0; Coef[st][1] = fn->a1; Coef[st][2] = fn->a2; Coef[st][3] = fn->b1; Coef[st][4] = fn->b2;
+        H[st][0] = h.xn1; H[st][1] = h.xn2; H[st][2] = h.yn1; H[st][3] = h.yn2;
+    }
+
+    Kern->Biquad_Chain(Src, Dest, num, Coef, H, Stages);
+
+    //R1.01 Store the history back.
+    for (int st = 0; st < Stages; st++)
+    {
+        tp_filterhist& h = Hist[Slot[st]];
+        h.xn1 = H[st][0]; h.xn2 = H[st][1]; h.yn1 = H[st][2]; h.yn2 = H[st][3];
+    }
+}
+
 //R1.00 Second order parametric/peaking boost filter with constant-Q. fc=Cutoff Frequency. Q=Filter width (.707 def).
-void MakoBiteAudioProcessor::Filter_BP_Coeffs(float Gain_dB, float Fc, float Q, tp_filter* fn)
+//R1.01 Only called from prepareToPlay. POWF and the other math never run on the audio thread.
+void MakoBiteAudioProcessor::Filter_BP_Coeffs(float Gain_dB, float Fc, float Q, tp_coeffs* cf)
 {    
-    float K = pi2 * (Fc * .5f) / SampleRate;
-    float K2 = K * K;
-    float V0 = pow(10.0, Gain_dB / 20.0);
+    //R1.01 Design is in MakoDSP, shared with MakoEngine so both give the same coefficients.
+    float c[5];
+    MakoDSP::Coeffs_BP(Gain_dB, Fc, Q, SampleRate, c);
+    Filter_CoeffsFrom(c, cf);
+}
 
-    float a = 1.0f + (V0 * K) / Q + K2;
-    float b = 2.0f * (K2 - 1.0f);
-    float g = 1.0f - (V0 * K) / Q + K2;
-    float d = 1.0f - K / Q + K2;
-    float dd = 1.0f / (1.0f + K / Q + K2);
+//R1.00 Second order LOW PASS filter.  fc=Cutoff Frequency.
+void MakoBiteAudioProcessor::Filter_LP_Coeffs(float fc, tp_coeffs* cf)
+{
+    float c[5];
+    MakoDSP::Coeffs_LP(fc, SampleRate, c);
+    Filter_CoeffsFrom(c, cf);
+}
 
-    fn->a0 = a * dd;
-    fn->a1 = b * dd;
-    fn->a2 = g * dd;
-    fn->b1 = b * dd;
-    fn->b2 = d * dd;
-    fn->c0 = 1.0f;
-    fn->d0 = 0.0f;
+//R1.01 Copy a0 a1 a2 b1 b2 from the shared designs into our coefficient struct.
+void MakoBiteAudioProcessor::Filter_CoeffsFrom(const float* c, tp_coeffs* cf)
+{
+    cf->a0 = c[0];
+    cf->a1 = c[1];
+    cf->a2 = c[2];
+    cf->b1 = c[3];
+    cf->b2 = c[4];
+    cf->c0 = 1.0f;
+    cf->d0 = 0.0f;
 }
 
-//R1.00 Second order LOW PASS filter.  fc=Cutoff Frequency.
-void MakoBiteAudioProcessor::Filter_LP_Coeffs(float fc, tp_filter* fn)
+//R1.01 Load new coefficients into a filter. With Ramp they glide there over FILTER_RampSegs segments
+//R1.01 so knob sweeps do not click.
+void MakoBiteAudioProcessor::Filter_SetCoeffs(const tp_coeffs* cf, tp_filter* fn, bool Ramp)
+{
+    fn->Target = *cf;
+
+    if (!Ramp)
+    {
+        fn->a0 = cf->a0; fn->a1 = cf->a1; fn->a2 = cf->a2; fn->b1 = cf->b1; fn->b2 = cf->b2; fn->c0 = cf->c0; fn->d0 = cf->d0;
+        fn->RampCnt = 0;
+        return;
+    }
+
+    float Div = 1.0f / FILTER_RampSegs;
+    fn->Step.a0 = (cf->a0 - fn->a0) * Div;
+    fn->Step.a1 = (cf->a1 - fn->a1) * Div;
+    fn->Step.a2 = (cf->a2 - fn->a2) * Div;
+    fn->Step.b1 = (cf->b1 - fn->b1) * Div;
+    fn->Step.b2 = (cf->b2 - fn->b2) * Div;
+    fn->RampCnt = FILTER_RampSegs;
+}
+
+//R1.01 Called once per segment. Moves the coefficients one step toward their target.
+void MakoBiteAudioProcessor::Filter_RampStep(tp_filter* fn)
 {
-    float c = 1.0f / (tanf(pi * fc / SampleRate));
-    fn->a0 = 1.0f / (1.0f + sqrt2 * c + (c * c));
-    fn->a1 = 2.0f * fn->a0;
-    fn->a2 = fn->a0;
-    fn->b1 = 2.0f * fn->a0 * (1.0f - (c * c));
-    fn->b2 = fn->a0 * (1.0f - sqrt2 * c + (c * c));
+    if (fn->RampCnt <= 0) return;
+
+    fn->RampCnt--;
+    if (fn->RampCnt == 0)
+    {
+        //R1.01 Land exactly on the target so rounding never builds up.
+        Filter_SetCoeffs(&fn->Target, fn, false);
+        return;
+    }
+
+    fn->a0 += fn->Step.a0;
+    fn->a1 += fn->Step.a1;
+    fn->a2 += fn->Step.a2;
+    fn->b1 += fn->Step.b1;
+    fn->b2 += fn->Step.b2;
+}
+
+//R1.01 Get our coefficient tables for the current sample rate. Called from prepareToPlay.
+//R1.01 If another instance already runs at this rate we get its tables, otherwise they are built here.
+void MakoBiteAudioProcessor::Filter_BuildTables()
+{
+    Filter_LPTable = Shared->Table_Get<tp_lptable>(MakoSharedTables::Table_Key(MakoSharedTables::e_Table_LP, SampleRate, 0),
+        [this](tp_lptable& Table)
+        {
+            for (int t = 0; t <= LP_Max - LP_Min; t++) Filter_LP_Coeffs(float(LP_Min + t), &Table.Coeffs[t]);
+        });
 }
 
 //F1.00 Second order butterworth High Pass. fc=Cutoff Frequency.
-void MakoBiteAudioProcessor::Filter_HP_Coeffs(float fc, tp_filter* fn)
+void MakoBiteAudioProcessor::Filter_HP_Coeffs(float fc, tp_coeffs* cf)
 { 
-    float c = tanf(pi * fc / SampleRate);
-    fn->a0 = 1.0f / (1.0f + sqrt2 * c + (c * c));
-    fn->a1 = -2.0f * fn->a0;
-    fn->a2 = fn->a0;
-    fn->b1 = 2.0f * fn->a0 * ((c * c) - 1.0f);
-    fn->b2 = fn->a0 * (1.0f - sqrt2 * c + (c * c));
+    float c[5];
+    MakoDSP::Coeffs_HP(fc, SampleRate, c);
+    Filter_CoeffsFrom(c, cf);
 }
 
 
@@ -389,26 +977,41 @@ void MakoBiteAudioProcessor::Balance_CalcSettings(bool ForceAll)
     if ((Setting[e_Bal] != Setting_Last[e_Bal]) || ForceAll)
     {
         Setting_Last[e_Bal] = Setting[e_Bal];
+
+        float BalL = 1.0f;
+        float BalR = 1.0f;
         if (Setting[e_Bal] < .5f)
-        {
-            Pedal_Bal1LR[0] = 1.0f;
-            Pedal_Bal1LR[1] = Setting[e_Bal] * 2.0f;
-        }
+            BalR = Setting[e_Bal] * 2.0f;
         else
-        {
-            Pedal_Bal1LR[0] = 1.0f - ((Setting[e_Bal] - .5f) * 2.0f);
-            Pedal_Bal1LR[1] = 1.0f;
-        }
+            BalL = 1.0f - ((Setting[e_Bal] - .5f) * 2.0f);
+
+        //R1.01 Even channels get the LEFT volume, odd channels get the RIGHT volume.
+        for (int t = 0; t < Chan_Cnt; t++) Chan_State[t].Pedal_Bal1LR = (t & 1) ? BalR : BalL;
     }
    
 }
 
 void MakoBiteAudioProcessor::Filter_CalcSettings(bool ForceAll)
 {
+    //R1.01 Fixed analysis filters only change with the sample rate.
+    if (ForceAll)
+    {
+        tp_coeffs cf;
+        Filter_HP_Coeffs(ANALYSIS_LoCutFreq, &cf);
+        Filter_SetCoeffs(&cf, &makoF_LoCut, false);
+        Filter_BP_Coeffs(ANALYSIS_EmphGain_dB, ANALYSIS_EmphFreq, ANALYSIS_EmphQ, &cf);
+        Filter_SetCoeffs(&cf, &makoF_Emph, false);
+    }
+
     if ((Setting[e_LP] != Setting_Last[e_LP]) || ForceAll)
     {
         Setting_Last[e_LP] = Setting[e_LP];
-        Filter_LP_Coeffs(Setting[e_LP], &makoF_HiCut1);        
+
+        //R1.01 Look up the coefficients. Glide to them unless this is a full reset.
+        //R1.01 Before prepareToPlay there is no table yet. prepareToPlay forces this again.
+        if (Filter_LPTable == nullptr) return;
+        int idx = juce::jlimit(0, LP_Max - LP_Min, int(Setting[e_LP] + .5f) - LP_Min);
+        for (int t = 0; t < ANALYSIS_LPStages; t++) Filter_SetCoeffs(&Filter_LPTable->Coeffs[idx], &makoF_HiCut[t], !ForceAll);
     }    
 }
 
@@ -434,106 +1037,433 @@ void MakoBiteAudioProcessor::Mako_Update_Delay(bool ForceAll)
     {
         Setting_Last[e_DTime] = Setting[e_DTime];        
 
-        //R1.00 Create the Left channel Echo Index and End of Buffer (Max).
-        Delay_B_Idx[0] = 2 * Setting[e_DTime] * SampleRate;
-        Delay_B_Idx_Max[0] = (2 * Setting[e_DTime] * SampleRate) + 1;
-        
-        //R1.00 Create the Right channel Echo Index and End of Buffer (Max).
-        //R1.00 Cut Delay Time in half so we have a stereo echo.
-        Delay_B_Idx[1] = 2 * Setting[e_DTime] * .5f * SampleRate;
-        Delay_B_Idx_Max[1] = (2 * Setting[e_DTime] * .5f * SampleRate) + 1;        
+        //R1.00 Create the Echo Index and End of Buffer (Max).
+        //R1.01 Each channel scales the delay time by its ratio. The default cuts the Right channel
+        //R1.01 Delay Time in half so we have a stereo echo.
+        for (int t = 0; t < Chan_Cnt; t++)
+        {
+            int Len = int(2 * Setting[e_DTime] * Delay_Ratio[t] * SampleRate);
+
+            //R1.01 Never run past the end of the buffer.
+            int LenMax = int(Delay_B[t].size()) - 2;
+            if (LenMax < Len) Len = LenMax;
+            if (Len < 0) Len = 0;
+
+            Chan_State[t].Delay_B_Idx = Len;
+            Chan_State[t].Delay_B_Idx_Max = Len + 1;
+        }
+    }
+
+    //R1.01 The delay is skipped while Delay Mix is 0. When it comes back up, clear the old echoes first.
+    bool DelayOn = (.001f <= Setting[e_DMix]);
+    if (DelayOn && !Delay_Run) Delay_Clear();
+    Delay_Run = DelayOn;
+}
+
+//R1.01 Clear the part of each delay buffer that is in use.
+void MakoBiteAudioProcessor::Delay_Clear()
+{
+    for (int t = 0; t < Chan_Cnt; t++)
+    {
+        MAKO_BOUNDS(0, Chan_State[t].Delay_B_Idx_Max + 1, Delay_B[t].size(), "Delay_Clear");
+        std::fill(Delay_B[t].begin(), Delay_B[t].begin() + Chan_State[t].Delay_B_Idx_Max + 1, 0.0f);
     }
 }
 
 
 
-float MakoBiteAudioProcessor::Mako_FX_MonoToneSyn(float tSample, int channel)
+float MakoBiteAudioProcessor::Mako_FX_MonoToneSyn(float tSample, float tAnalysis, int channel)
 {
+    tp_chanstate& cs = Chan_State[channel];
     float tS = tSample;
     float tS2 = tSample;
     float Gliss = Setting[e_Gliss] - .01f;
 
     //R1.00 Exit if not even using Synth.
-    if ((int(Setting[e_Voice]) == 0) || (Setting[e_Mix] < .001f)) return tSample;
+    //R1.01 MIDI out still needs the pitch tracker even when the synth is off.
+    bool SynthOn = (int(Setting[e_Voice]) != 0) && (.001f <= Setting[e_Mix]);
+    bool MidiOn = Pedal_Midi && (channel == 0);
+    if (!SynthOn && !MidiOn) return tSample;
 
     // VOLUME ENVELOPE CODE ******************************************************************************
     //R1.00 Apply some psuedo compression to the peak value. To smooth out the picking dynamic range.
     //R1.00 This func does not exeed -1/1 so it is volume safe.
-    float tP = abs(tanhf(tS * (.01f + Setting[e_PreGain]) * 8.0f));
+    float tP = MakoDSP::Peak_Level(tS, Setting[e_PreGain]);
 
     //R1.00 Slowly decrease our peak detected volume. Set to new Peak if applicable.
-    Mod_Peak[channel] *= .995f;
-    if (Mod_Peak[channel] < tP) Mod_Peak[channel] = tP;
+    //R1.01 Release time comes from Env_Peak so it is the same at every sample rate.
+    cs.Mod_Peak = juce::jmax(cs.Mod_Peak * Env_Peak.Coef, tP);
     // VOLUME ENVELOPE CODE ******************************************************************************
 
     // PITCH DETECTION CODE ******************************************************************************
     //R1.00 Update our Sample Count since the last ZERO crossing..
     //R1.00 Our pitch is sample counts between crossings.
-    Mod_PitchCnt[channel]++;
+    cs.Mod_PitchCnt++;
 
     //R1.00 Low Pass filter on incoming signal to reduce highs. The more we cut the closer to a sine
     //R1.00 wave we get and the better our tracking is. Too much and high notes stop working.
-    tS = Filter_Calc_BiQuad(tS, channel, &makoF_HiCut1);
+    //R1.01 Already done for the whole segment by Filter_Analysis_Block.
+    tS = tAnalysis;
     
     //R1.00 Find Rising Edge ZERO crossing. Update Pitch change rate. Store last Sample value.
     //R1.00 Here is the heart of the app. We calc pitch from samples per crossing. Then blend the new pitch to create Glissando effect.
-    if ((Mod_LastSample[channel] < 0.0f) && (0.0f < tS))
+    if ((cs.Mod_LastSample < 0.0f) && (0.0f < tS))
     {
         //R1.00 Blend new pitch with old for Glissando. PI2 = 6.263
-        Mod_PitchInc[channel] = (Mod_PitchInc[channel] * Gliss) + ((pi2 / Mod_PitchCnt[channel]) * (1.0f - Gliss));
+        //R1.01 Never below 0, see MakoDSP::Pitch_Blend.
+        cs.Mod_PitchInc = MakoDSP::Pitch_Blend(cs.Mod_PitchInc, cs.Mod_PitchCnt, Gliss);
 
         //R1.00 Limit our highest pitch so noise doesnt drive it higher. Probably dont need this. Needs to be SampleRate dependent.
-        //if (.16f < Mod_PitchInc[channel]) Mod_PitchInc[channel] = .16f;
+        //if (.16f < cs.Mod_PitchInc) cs.Mod_PitchInc = .16f;
+
+        //R1.01 Convert to our integer phase step.
+        cs.Mod_PhaseInc = MakoDSP::Phase_Step(cs.Mod_PitchInc);
+
+        cs.Mod_PitchCnt = 0; //R1.00 Reset our sample counter.
 
-        Mod_PitchCnt[channel] = 0; //R1.00 Reset our sample counter.
+        //R1.01 Update the sample voice playback rate.
+        if (int(Setting[e_Voice]) == VOICE_Sample) Sample_PitchDetected(channel);
+
+        //R1.01 Send the new pitch to MIDI.
+        if (MidiOn) Midi_PitchDetected(channel);
     }
-    Mod_LastSample[channel] = tS;
+    cs.Mod_LastSample = tS;
+
+    //R1.01 End any MIDI note when the player stops.
+    if (MidiOn) Midi_CheckGate(channel);
     // PITCH DETECTION CODE ******************************************************************************
 
+    //R1.01 Synth is off, MIDI only.
+    if (!SynthOn) return tSample;
+
     // SYNTH SOUND GENERATION CODE ******************************************************************************
     //R1.00 Increment our sig gen and limit range to 0.0 - (X*PI) or the loss of floating point resolution causes errors.
-    Mod_Sin[channel] += Mod_PitchInc[channel];
-    if ((2.0f * pi2) < Mod_Sin[channel]) Mod_Sin[channel] -= (2.0f * pi2);
+    //R1.01 Integer phase wraps at 4PI by itself and never loses resolution.
+    cs.Mod_Phase += cs.Mod_PhaseInc;
 
     //R1.00 Create the SINE wave gen signal.
-    //R1.00 This is not the fastest/best way to do this probably. Lambda function maybe? SINF are also expensive for CPU.
-    switch (int(Setting[e_Voice]))
-    {
-        case 1:tS2 = (sinf(Mod_Sin[channel]) + sinf(Mod_Sin[channel] * 2.0f)); break;
-        case 2:tS2 = .75f * ((cosf(Mod_Sin[channel]) + sinf(Mod_Sin[channel] * 2.0f) + sinf(Mod_Sin[channel] * 1.5833333f))); break;
-        case 3: (0.0f < sinf(Mod_Sin[channel])) ? tS2 = .5f : tS2 = -.5f;   break;
-        case 4:
-            (0.0f < sinf(Mod_Sin[channel])) ? tS2 = 1.0f : tS2 = -1.0f;
-            tS2 += sinf(Mod_Sin[channel] * 4.0f);
-            tS2 *= .333f;
-            break;
-        case 5:tS2 = sinf(Mod_Sin[channel]) + sinf(Mod_Sin[channel] * 1.5833333f); break;
-        case 6:tS2 = sinf(Mod_Sin[channel]) + sinf(Mod_Sin[channel] * 2.0f); break;
-        case 7:tS2 = sinf(Mod_Sin[channel] * 2.0f) + (sinf(Mod_Sin[channel] * 4.0f) * .1f); break;
-        case 8:tS2 = sinf(Mod_Sin[channel]) + (sinf(Mod_Sin[channel] * 2.0f) * .1f); break;
-        case 9:tS2 = sinf(Mod_Sin[channel] * .5f) + (sinf(Mod_Sin[channel] * 4.0f) * .1f); break;
-        case 10: 
-            (0.0f < sinf(Mod_Sin[channel] * .5f)) ? tS2 = 1.0f : tS2 = -1.0f;
-            tS2 += sinf(Mod_Sin[channel] * 1.3340909f);
-            tS2 *= .333f;
-            break;
-        //R1.00 Default for when things go horribly wrong.
-        default: tS2 = 1.5f * sinf(Mod_Sin[channel]); break;
-    }
+    //R1.01 Voices 1 - 10 are in MakoDSP::Voice_Render. The governor can drop the table interpolation.
+    int Voice = int(Setting[e_Voice]);
+    if (Voice == VOICE_Sample)
+        tS2 = Sample_Render(channel);
+    else if (Osc_Nearest)
+        tS2 = MakoDSP::Voice_Render<true>(SIN_Table, Voice, cs.Mod_Phase, cs.Mod_PhaseInc);
+    else
+        tS2 = MakoDSP::Voice_Render<false>(SIN_Table, Voice, cs.Mod_Phase, cs.Mod_PhaseInc);
     // SYNTH SOUND GENERATION CODE ******************************************************************************
 
     //R1.00 Scale the volume to our peak vol.
-    tS2 *= Mod_Peak[channel];
+    //R1.01 BOOST and BALANCE are done for the whole segment by Mako_FX_Boost.
+    return tS2 * cs.Mod_Peak;
+}
+
+//R1.00 BOOST.
+//R1.01 Adds harmonics with SINF as before, then matches the level to what went in so sweeping Boost does
+//R1.01 not jump the volume. Levels are measured per segment, the gain is ramped so there are no steps.
+void MakoBiteAudioProcessor::Mako_FX_Boost(float* Buf, int num, int channel)
+{
+    tp_chanstate& cs = Chan_State[channel];
+    MakoDSP::t_BoostLevel& bl = Boost_Level[channel];
 
-    //R1.00 Apply BOOST if selected. Gain calculated in SettingsUpdate.
-    if (0.0f < Setting[e_Boost]) tS2 = BOOST_Gain * sinf(tS2 * Setting[e_Boost] * 50.0f);        
-    
     //R1.00 Return the BALANCE adjusted signal.
-    return tS2 * Pedal_Bal1LR[channel];
+    if (Setting[e_Boost] <= 0.0f)
+    {
+        //R1.01 Start clean the next time Boost is turned up.
+        bl = MakoDSP::t_BoostLevel();
+        Kern->Scale(Buf, num, cs.Pedal_Bal1LR);
+        return;
+    }
+
+    //R1.01 Ramp from the last gain to the new one with the balance folded in.
+    float Start, Step;
+    MakoDSP::Boost_Segment(Buf, 1, num, Setting[e_Boost] * 50.0f, Env_Boost.CoefPow[num], Boost_Table ? SIN_Table : nullptr, bl, Start, Step);
+    float Bal = cs.Pedal_Bal1LR;
+    Kern->Gain_Ramp(Buf, Buf, num, Start * Bal, Step * Bal);
+}
+
+void MakoBiteAudioProcessor::Channels_Resize(int Channels)
+{
+    //R1.01 Called from prepareToPlay. Audio is not running so we can allocate here.
+    if (Channels < 1) Channels = 1;
+
+    //R1.01 Keep any delay ratios that were set by the user. New channels get the default L/R ratio.
+    int OldCnt = int(Delay_Ratio.size());
+    Delay_Ratio.resize(Channels);
+    for (int t = OldCnt; t < Channels; t++) Delay_Ratio[t] = (t & 1) ? .5f : 1.0f;
+    Delay_RatioReq.reset(new std::atomic<float>[size_t(Channels)]);
+    for (int t = 0; t < Channels; t++) Delay_RatioReq[t].store(0.0f);
+
+    //R1.01 Room for every parameter and every channel's ratio past PARMEVENT_Max. See Parm_QueueEvent.
+    Parm_Events.assign(size_t(PARMEVENT_Max + PARM_Ratio + Channels), tp_parmevent());
+    Parm_EventCnt = 0;
+
+    //R1.01 Every channel starts from a clean state. Filter history, oscillators and delay positions are cleared.
+    Chan_Cnt = Channels;
+    Chan_State.assign(Channels, tp_chanstate());
+    Boost_Level.assign(Channels, MakoDSP::t_BoostLevel());
+   #if MAKO_REFERENCE_CHECK
+    Ref_Phase.assign(Channels, 0.0);
+    Ref_Step.assign(Channels, 0.0);
+   #endif
+
+    //R1.01 Delay buffer holds the longest echo. Delay Time (1.0) * 2 * Ratio (1.0) seconds.
+    Delay_B.resize(Channels);
+    for (int t = 0; t < Channels; t++) Delay_B[t].assign(size_t(2.0f * SampleRate) + 4, 0.0f);
+}
+
+void MakoBiteAudioProcessor::Record_Start(const juce::File& CaptureFile)
+{
+    Record_File = CaptureFile;
+}
+
+void MakoBiteAudioProcessor::Record_Stop()
+{
+    //R1.01 Audio must be stopped.
+    Record_File = juce::File();
+    Recorder.Stop();
+}
+
+//R1.01 First record of a capture. Everything replay needs to start from the same state we did.
+void MakoBiteAudioProcessor::Record_Header(int samplesPerBlock)
+{
+    t_RecHeader Hdr = {};
+    Hdr.Type = MakoRecorder::e_Rec_Header;
+    Hdr.Magic = MakoRecorder::REC_Magic;
+    Hdr.Version = MakoRecorder::REC_Version;
+    Hdr.MaxBlock = samplesPerBlock;
+    Hdr.SampleRate = getSampleRate();
+    Hdr.NumIn = getTotalNumInputChannels();
+    Hdr.NumOut = getTotalNumOutputChannels();
+    Hdr.Mono = Pedal_Mono;
+    Hdr.Midi = Pedal_Midi;
+    Hdr.BypassOn = Bypass_On ? 1 : 0;
+    Hdr.ParmCnt = PARM_Cnt;
+    Hdr.ChanCnt = Chan_Cnt;
+
+    if (!Recorder.Record_Begin(int(sizeof(Hdr) + sizeof(float) * (PARM_Cnt + Chan_Cnt)))) return;
+    Recorder.Record_Write(&Hdr, sizeof(Hdr));
+    Recorder.Record_Write(Setting, sizeof(float) * PARM_Cnt);
+    Recorder.Record_Write(Delay_Ratio.data(), int(sizeof(float)) * Chan_Cnt);
+}
+
+//R1.01 Audio thread. One record per block: our settings, this block's events and the input audio.
+void MakoBiteAudioProcessor::Record_Block(const juce::AudioBuffer<float>& buffer, int Type)
+{
+    if (!Recorder.IsActive()) return;
+
+    t_RecBlock Blk;
+    Blk.Type = Type;
+    Blk.NumSamples = buffer.getNumSamples();
+    Blk.NumChannels = buffer.getNumChannels();
+    Blk.Mono = Pedal_Mono;
+    Blk.Midi = Pedal_Midi;
+    Blk.SettingsChanged = SettingsChanged;
+    Blk.EventCnt = Parm_EventCnt;
+    Blk.ForceAll = Settings_Force ? 1 : 0;
+    Blk.GovLevel = Gov_Level.load();          //R1.01 Governor_Update runs after the block, so this is the level it runs at.
+
+    int Bytes = int(sizeof(Blk) + sizeof(float) * PARM_Cnt + sizeof(t_RecEvent) * Parm_EventCnt) + int(sizeof(float)) * Blk.NumChannels * Blk.NumSamples;
+    if (!Recorder.Record_Begin(Bytes)) return;
+
+    Recorder.Record_Write(&Blk, sizeof(Blk));
+    Recorder.Record_Write(Setting, sizeof(float) * PARM_Cnt);
+    for (int t = 0; t < Parm_EventCnt; t++)
+    {
+        t_RecEvent Ev = { Parm_Events[t].offset, Parm_Events[t].idx, Parm_Events[t].value };
+        Recorder.Record_Write(&Ev, sizeof(Ev));
+    }
+    for (int t = 0; t < Blk.NumChannels; t++)
+        Recorder.Record_Write(buffer.getReadPointer(t), int(sizeof(float)) * Blk.NumSamples);
+}
+
+void MakoBiteAudioProcessor::Replay_Prepare(const t_RecHeader& Hdr, const float* Settings, const float* Ratios)
+{
+    //R1.01 From here on host automation is ignored. Every change comes from the capture.
+    Replay_On = true;
+
+    for (int t = 0; t < juce::jmin(PARM_Cnt, int(Hdr.ParmCnt)); t++) Setting[t] = Settings[t];
+    Pedal_Mono = Hdr.Mono;
+    Pedal_Midi = Hdr.Midi;
+    Bypass_On = (Hdr.BypassOn != 0);
+    Delay_Ratio.assign(Ratios, Ratios + Hdr.ChanCnt);
+}
+
+void MakoBiteAudioProcessor::Replay_Block(const t_RecBlock& Blk, const float* Settings, const t_RecEvent* Events)
+{
+    //R1.01 Put back exactly what the recorded block saw after its host poll.
+    for (int t = 0; t < PARM_Cnt; t++) Setting[t] = Settings[t];
+    SettingsChanged = Blk.SettingsChanged;
+    Settings_Force = (Blk.ForceAll != 0);
+    Pedal_Mono = Blk.Mono;
+    Pedal_Midi = Blk.Midi;
+
+    //R1.01 Run at the quality the recorded block ran at, not whatever our own timing would pick.
+    int Level = juce::jlimit(int(e_Gov_Full), e_Gov_Levels - 1, int(Blk.GovLevel));
+    if (Gov_Level.load() != Level) Governor_Apply(Level);
+
+    Parm_EventCnt = juce::jmin(int(Blk.EventCnt), int(Parm_Events.size()));
+    for (int t = 0; t < Parm_EventCnt; t++)
+    {
+        Parm_Events[t].offset = Events[t].Offset;
+        Parm_Events[t].idx = Events[t].Idx;
+        Parm_Events[t].value = Events[t].Value;
+    }
+}
+
+float MakoBiteAudioProcessor::Track_Freq(int channel) const
+{
+    if ((channel < 0) || (Chan_Cnt <= channel)) return 0.0f;
+    return Chan_State[channel].Mod_PitchInc * SampleRate / pi2;
+}
+
+void MakoBiteAudioProcessor::Delay_SetChannelRatio(int channel, float Ratio)
+{
+    //R1.01 Only channels we have state for can be set. Call again after a layout change.
+    if ((channel < 0) || (Chan_Cnt <= channel)) return;
+
+    //R1.01 The next block takes it as a parameter event at its first sample, so it is recorded and replayed.
+    Delay_RatioReq[channel].store(juce::jlimit(.01f, 1.0f, Ratio));
+}
+
+void MakoBiteAudioProcessor::SampleVoice_Load(const juce::File& Source)
+{
+    //R1.01 Save the path with our state so the DAW project reloads it.
+    parameters.state.setProperty("samplepath", Source.getFullPathName(), nullptr);
+    SampleLoader.Request(Source);
+}
+
+void MakoBiteAudioProcessor::Sample_PitchDetected(int channel)
+{
+    tp_chanstate& cs = Chan_State[channel];
+    //R1.01 Called at each rising zero crossing. Pick the zone for this pitch and its playback step.
+    if (Sample_Active == nullptr) return;
+
+    float Freq = cs.Mod_PitchInc * SampleRate / pi2;
+    if (Freq < 1.0f) return;
+
+    float Note = 69.0f + 12.0f * log2f(Freq / 440.0f);
+    int zone = Sample_Active->Zone_Find(Note);
+    const t_SampleZone* zn = Sample_Active->Zones[zone].get();
+
+    //R1.01 Start a new zone at its beginning.
+    if (zone != cs.Sample_Zone) cs.Sample_Pos = 0.0;
+    cs.Sample_Zone = zone;
+    cs.Sample_Step = float((Freq / zn->RootFreq) * (zn->FileRate / SampleRate));
+}
+
+float MakoBiteAudioProcessor::Sample_Render(int channel)
+{
+    tp_chanstate& cs = Chan_State[channel];
+    //R1.01 No file loaded yet. Play silence.
+    if (Sample_Active == nullptr) return 0.0f;
+
+    //R1.01 Single cycle waveform. Use our oscillator angle so it tracks exactly like the other voices.
+    //R1.01 Mod_Phase runs 0 - 4PI so it holds two cycles.
+    const t_SampleZone* zn0 = Sample_Active->Zones[0].get();
+    if ((Sample_Active->Zones.size() == 1) && zn0->SingleCycle)
+    {
+        float Cycle = float(cs.Mod_Phase << 1) * MakoDSP::PHASE_ToUnit;
+        return 1.5f * Sample_Active->Zone_Read(0, double(Cycle) * double(zn0->Length));
+    }
+
+    //R1.01 Multi sample zones. Wait for the first zero crossing to pick a zone.
+    int zone = cs.Sample_Zone;
+    if ((zone < 0) || (int(Sample_Active->Zones.size()) <= zone)) return 0.0f;
+
+    const t_SampleZone* zn = Sample_Active->Zones[zone].get();
+    float tS = Sample_Active->Zone_Read(zone, cs.Sample_Pos);
+
+    //R1.01 Step through the file. At the loop end go back one loop length. Zone_Read has already
+    //R1.01 faded the end into the audio before LoopStart, so there is no click.
+    cs.Sample_Pos += cs.Sample_Step;
+    if (double(zn->LoopEnd) <= cs.Sample_Pos) cs.Sample_Pos -= double(zn->LoopEnd - zn->LoopStart);
+    if (double(zn->LoopEnd) <= cs.Sample_Pos) cs.Sample_Pos = double(zn->LoopStart);
+
+    return tS;
+}
+
+//R1.01 Our MIDI is built in Midi_Work, which was sized in prepareToPlay, so the only growth left on
+//R1.01 the audio thread is the host's own buffer. Hosts and the plugin wrappers reserve that themselves.
+void MakoBiteAudioProcessor::Midi_Flush(juce::MidiBuffer& midiMessages)
+{
+    if (!Midi_Work.isEmpty()) midiMessages.addEvents(Midi_Work, 0, -1, 0);
+}
+
+void MakoBiteAudioProcessor::Midi_PitchDetected(int channel)
+{
+    tp_chanstate& cs = Chan_State[channel];
+    //R1.01 Called at each rising zero crossing. Turns our tracked pitch into a MIDI note.
+    if (Midi_Out == nullptr) return;
+
+    //R1.01 Too quiet to trust the pitch.
+    if ((cs.Mod_Peak < MIDI_GateOn) && (Midi_Note < 0)) return;
+
+    //R1.01 Mod_PitchInc is radians per sample. Convert to Hz, then to a fractional MIDI note.
+    float Freq = cs.Mod_PitchInc * SampleRate / pi2;
+    if ((Freq < 20.0f) || (5000.0f < Freq)) return;
+    float Note = 69.0f + 12.0f * log2f(Freq / 440.0f);
+
+    //R1.01 Start a new note if nothing is playing.
+    if (Midi_Note < 0)
+    {
+        Midi_Note = juce::jlimit(0, 127, int(Note + .5f));
+        Midi_Bend = 8192;
+        Midi_NewNoteCnt = 0;
+        Midi_Out->addEvent(juce::MidiMessage::pitchWheel(MIDI_Channel, Midi_Bend), Midi_Offset);
+        Midi_Out->addEvent(juce::MidiMessage::noteOn(MIDI_Channel, Midi_Note, juce::uint8(juce::jlimit(1, 127, int(cs.Mod_Peak * 127.0f)))), Midi_Offset);
+        return;
+    }
+
+    //R1.01 Retrigger only if the pitch has moved past our hysteresis for two crossings in a row.
+    //R1.01 This keeps vibrato and tracking noise from chattering notes.
+    float Diff = Note - float(Midi_Note);
+    if (MIDI_NoteHyst < fabsf(Diff))
+    {
+        Midi_NewNoteCnt++;
+        if (2 <= Midi_NewNoteCnt)
+        {
+            Midi_Out->addEvent(juce::MidiMessage::noteOff(MIDI_Channel, Midi_Note, juce::uint8(0)), Midi_Offset);
+            Midi_Note = juce::jlimit(0, 127, int(Note + .5f));
+            Midi_Bend = 8192;
+            Midi_NewNoteCnt = 0;
+            Midi_Out->addEvent(juce::MidiMessage::pitchWheel(MIDI_Channel, Midi_Bend), Midi_Offset);
+            Midi_Out->addEvent(juce::MidiMessage::noteOn(MIDI_Channel, Midi_Note, juce::uint8(juce::jlimit(1, 127, int(cs.Mod_Peak * 127.0f)))), Midi_Offset);
+        }
+        return;
+    }
+    Midi_NewNoteCnt = 0;
+
+    //R1.01 Small pitch changes are sent as pitch bend. Only send when it moves enough to matter.
+    int Bend = juce::jlimit(0, 16383, 8192 + int((Diff / MIDI_BendRange) * 8191.0f));
+    if (32 < abs(Bend - Midi_Bend))
+    {
+        Midi_Bend = Bend;
+        Midi_Out->addEvent(juce::MidiMessage::pitchWheel(MIDI_Channel, Midi_Bend), Midi_Offset);
+    }
+}
+
+void MakoBiteAudioProcessor::Midi_CheckGate(int channel)
+{
+    tp_chanstate& cs = Chan_State[channel];
+    //R1.01 Note off when the level falls below the lower gate threshold.
+    if ((0 <= Midi_Note) && (cs.Mod_Peak < MIDI_GateOff)) Midi_NoteOff(Midi_Offset);
+}
+
+void MakoBiteAudioProcessor::Midi_NoteOff(int offset)
+{
+    if ((Midi_Out == nullptr) || (Midi_Note < 0)) return;
+
+    Midi_Out->addEvent(juce::MidiMessage::noteOff(MIDI_Channel, Midi_Note, juce::uint8(0)), offset);
+    Midi_Out->addEvent(juce::MidiMessage::pitchWheel(MIDI_Channel, 8192), offset);
+    Midi_Note = -1;
+    Midi_Bend = 8192;
+    Midi_NewNoteCnt = 0;
 }
 
 void MakoBiteAudioProcessor::Settings_Update(bool ForceAll)
 {
+    MAKO_TRACE_SCOPE("Settings_Update");
+
     //R1.00 We do changes here so we know the vars are not in use while we change them.
     //R1.00 EDITOR sets SETTING flags and we make changes here.
 
@@ -543,81 +1473,151 @@ void MakoBiteAudioProcessor::Settings_Update(bool ForceAll)
     //R1.00 Update our BALANCE settings.
     Balance_CalcSettings(ForceAll);
 
+    //R1.01 Update the ATTACK envelope rates.
+    Attack_CalcSettings(ForceAll);
+
     //R1.00 Update the delay settings.
     Mako_Update_Delay(ForceAll);
 
-    //R1.00 Reduce gain to compensate for the added gain and harmonics (rms value).
-    //R1.00 It is put here because it needs to be more complex than this.
-    //R1.00 Basically the most gain happens from 0-.25 depending on PreGain setting.
-    if (0.0f < Setting[e_Boost])
-    {
-        BOOST_Gain = 1.0f - (Setting[e_Boost] * 5.0f);
-        if (BOOST_Gain < .1f) BOOST_Gain = .1f;
-    }
-
     //R1.00 RESET our settings flags.
-    SettingsChanged -= 1;
-    if (SettingsChanged < 0) SettingsChanged = 0;
+    //R1.01 A full update covers everything that was waiting.
+    if (ForceAll) SettingsChanged = 0;
+    else if (--SettingsChanged < 0) SettingsChanged = 0;
 
 }
 
-float MakoBiteAudioProcessor::Mako_FX_Attack(float tSample, int channel)
+void MakoBiteAudioProcessor::Envelope_Coeffs(float ms, tp_envelope* env)
 {
-    //R1.00 Attack is turned off (0.0) so skip this code and return.
-    if (Setting[e_Attack] < .001f) return tSample;
+    //R1.01 One pole coefficient for a time constant in milliseconds. Only called from Settings_Update.
+    env->Coef = MakoDSP::Env_Coef(ms, SampleRate);
 
-    //R1.00 Calculate our average incoming signal. Blend it for some fixed amount of time. Needs SampleRate calc.
-    Signal_AVG[channel] = (Signal_AVG[channel] * .995f) + (abs(tSample) * .005f);
+    //R1.01 Powers of the coefficient so a segment of N samples can be updated with one multiply.
+    MakoDSP::Env_Powers(env->Coef, env->CoefPow, SEGMENT_Size);
+}
 
-    //R1.00 A slow envelope attack for violin/synth effects.
-    //R1.00 Detect when a note is played. And retrigger the Attack fade in.
-    //R1.00 This code lets players play non-attacked notes if no silence is between notes.
-    if (!Signal_VolFadeOn[channel] && (.001f < tSample))
+void MakoBiteAudioProcessor::Attack_CalcSettings(bool ForceAll)
+{
+    //R1.01 Envelope times only depend on the sample rate. ForceAll is set from prepareToPlay and after a state load.
+    if (ForceAll)
     {
-        Signal_VolFadeOn[channel] = true;
-        Signal_VolFade[channel] = 0.0f;
+        Envelope_Coeffs(MakoDSP::ENV_Peak_ms, &Env_Peak);
+        Envelope_Coeffs(MakoDSP::ENV_Avg_ms, &Env_Avg);
+        Envelope_Coeffs(MakoDSP::ENV_FadeOut_ms, &Env_FadeOut);
+        Envelope_Coeffs(MakoDSP::ENV_Boost_ms, &Env_Boost);
     }
 
-    //R1.00 Check for Note off period.
-    if (Signal_AVG[channel] < .0001f) Signal_VolFadeOn[channel] = false;
-
-    //R1.00 Ramp up or down the effect volume based on if playing or not.
-    if (.0005f < Signal_AVG[channel])
-        Signal_VolFade[channel] += .000001f + (1.0f - Setting[e_Attack]) * .0001f; //R1.00 Fade in.
-    else
-        Signal_VolFade[channel] *= -.995f;                                         //R1.00 Fade out.
+    //R1.01 Fade in rate. Attack 0 = about .2 seconds, Attack 1 = about 20 seconds.
+    //R1.01 Stored as volume change per second and converted to per sample.
+    if ((Setting[e_Attack] != Setting_Last[e_Attack]) || ForceAll)
+    {
+        Setting_Last[e_Attack] = Setting[e_Attack];
+        Attack_Inc = (.048f + (1.0f - Setting[e_Attack]) * 4.8f) / SampleRate;
+    }
+}
 
-    //R1.00 Clip the volume near unity.
-    if (.9999f < Signal_VolFade[channel]) Signal_VolFade[channel] = .9999f;
+void MakoBiteAudioProcessor::Mako_FX_Attack(const float* Src, float* Dest, int num, int channel)
+{
+    tp_chanstate& cs = Chan_State[channel];
+    //R1.00 Attack is turned off (0.0) so skip this code and return.
+    if (Setting[e_Attack] < .001f)
+    {
+        Kern->Copy(Dest, Src, num);
+        return;
+    }
 
-    return tSample * Signal_VolFade[channel];
+    //R1.01 The envelope is run at segment rate (MakoDSP::Attack_Envelope), then ramped across the segment.
+    float VolStart, VolStep;
+    MakoDSP::Attack_Envelope(Src, 1, num, Env_Avg.CoefPow[num], Env_FadeOut.CoefPow[num], Attack_Inc,
+                             cs.Signal_AVG, cs.Signal_VolFade, cs.Signal_VolFadeOn, VolStart, VolStep);
+    Kern->Gain_Ramp(Src, Dest, num, VolStart, VolStep);
 }
 
 
 //R1.00 DIGITAL DELAY.
-float MakoBiteAudioProcessor::Mako_FX_Delay(float tSample, int channel)
+//R1.01 Done a segment at a time. Between wraps each buffer position is read and written once, so the
+//R1.01 run up to the wrap point has no sample to sample dependency and goes to the Delay_Mix kernel.
+void MakoBiteAudioProcessor::Mako_FX_Delay_Block(float* Buf, int num, int channel)
 {
+    tp_chanstate& cs = Chan_State[channel];
     //R1.00 Exit if not even using Delay.
-    if (Setting[e_DMix] < .001f) return tSample;
+    if (Setting[e_DMix] < .001f) return;
 
-    //R1.00 Get the index into our Delay buffer where our current echo is.
-    long idx = Delay_B_Idx[channel];
+    MakoDSP::Delay_Segment(Buf, num, Delay_B[channel].data(), Delay_B[channel].size(), cs.Delay_B_Idx, cs.Delay_B_Idx_Max,
+                           Delay_Dry, Delay_Wet, Setting[e_DLen], Kern->Delay_Mix);
+}
+
+//R1.01 Add this block to the governor window. At the end of a window, step quality down or up.
+void MakoBiteAudioProcessor::Governor_Update(juce::int64 Start, int num)
+{
+    //R1.01 A replay takes its level from each recorded block in Replay_Block.
+    if (Replay_On) return;
 
-    //R1.00 Mix our signal with the echo.
-    float NewSignal = (tSample * Delay_Dry) + ((Delay_B[channel][idx] * Delay_Wet));
+    if (!Pedal_Governor)
+    {
+        if (Gov_Level.load() != e_Gov_Full) Governor_Apply(e_Gov_Full);
+        Gov_Ticks = 0;
+        Gov_Samples = 0;
+        Gov_Calm = 0;
+        Gov_Load = 0.0f;
+        return;
+    }
 
-    //R1.00 Update the buffer with our new sample and old echo mixed. 
-    //R1.00 We cant exceed -1/1 so we put in .5f sample volume. .5+.5 = 1 (safe).
-    Delay_B[channel][idx] = (.5f * tSample) + (Delay_B[channel][idx] * Setting[e_DLen]);
+    //R1.01 A governor switched on mid block has no start time. Start with the next block.
+    if (Start == 0) return;
 
-    //R1.00 Update delay buffer position. 
-    Delay_B_Idx[channel]++;
+    Gov_Ticks += juce::Time::getHighResolutionTicks() - Start;
+    Gov_Samples += num;
+    if (Gov_Samples < Gov_WindowLen) return;
 
-    //R1.00 If the index is past the buffer limit, go back to the start of the buffer. Wrap around.
-    if (Delay_B_Idx_Max[channel] < Delay_B_Idx[channel]) Delay_B_Idx[channel] = 0;
+    //R1.01 Time we took / time the audio lasts.
+    float Load = float((double(Gov_Ticks) / Gov_TickRate) / (double(Gov_Samples) / Gov_HostRate));
+    Gov_Load = Load;
+    Gov_Ticks = 0;
+    Gov_Samples = 0;
 
-    return NewSignal;
+    int Level = Gov_Level.load();
+    if (GOV_StepDown < Load)
+    {
+        Gov_Calm = 0;
+        if (Level < e_Gov_Levels - 1) Governor_Apply(Level + 1);
+    }
+    else if (Load < GOV_StepUp)
+    {
+        if ((GOV_UpWindows <= ++Gov_Calm) && (e_Gov_Full < Level))
+        {
+            Gov_Calm = 0;
+            Governor_Apply(Level - 1);
+        }
+    }
+    else
+    {
+        Gov_Calm = 0;
+    }
 }
 
+//R1.01 Switch every cheaper mode on or off for this quality level. Audio thread, between blocks.
+void MakoBiteAudioProcessor::Governor_Apply(int Level)
+{
+    Osc_Nearest = (e_Gov_Osc <= Level);
+    Boost_Table = (e_Gov_Boost <= Level);
+
+    //R1.01 HiCut stages coming back start from silence, not from history they held before they stopped.
+    int LPRun = (e_Gov_Analysis <= Level) ? 1 : ANALYSIS_LPStages;
+    for (int t = 0; t < Chan_Cnt; t++)
+        for (int st = Analysis_LPRun; st < LPRun; st++) Chan_State[t].Filt[FILT_HiCut + st] = {};
+    Analysis_LPRun = LPRun;
 
+    Gov_Level = Level;
+}
 
+const char* MakoBiteAudioProcessor::Governor_Name(int Level)
+{
+    switch (Level)
+    {
+        case e_Gov_Full:     return "Full";
+        case e_Gov_Osc:      return "Fast Osc";
+        case e_Gov_Boost:    return "Fast Boost";
+        case e_Gov_Analysis: return "Fast Tracking";
+    }
+    return "";
+}
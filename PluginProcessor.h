@@ -9,6 +9,28 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "MakoSampleVoice.h"
+#include "MakoSharedTables.h"
+#include "MakoRecorder.h"
+#include "MakoTrace.h"
+#include "MakoResampler.h"
+#include "MakoKernels.h"
+#include "MakoDSP.h"
+
+//R1.01 Reference builds keep a frozen copy of our scalar DSP next to the optimized code. See MakoReference.cpp.
+#ifndef MAKO_REFERENCE_CHECK
+ #define MAKO_REFERENCE_CHECK 0
+#endif
+
+//R1.01 CLAP hooks only. There is no CLAP target in this project. A CMake build that wraps these sources with
+//R1.01 clap-juce-extensions (clap_juce_extensions_plugin) sets MAKO_CLAP=1. See CLAP BUILDS in the README.
+#ifndef MAKO_CLAP
+ #define MAKO_CLAP 0
+#endif
+
+#if MAKO_CLAP
+ #include <clap-juce-extensions/clap-juce-extensions.h>
+#endif
 
 //==============================================================================
 /**
@@ -17,6 +39,9 @@ class MakoBiteAudioProcessor  : public juce::AudioProcessor
                             #if JucePlugin_Enable_ARA
                              , public juce::AudioProcessorARAExtension
                             #endif
+                            #if MAKO_CLAP
+                             , public clap_juce_extensions::clap_juce_audio_processor_capabilities
+                            #endif
 {
 public:
     //==============================================================================
@@ -32,6 +57,7 @@ public:
    #endif
 
     void processBlock (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlockBypassed (juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
 
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
@@ -56,16 +82,60 @@ public:
     void getStateInformation (juce::MemoryBlock& destData) override;
     void setStateInformation (const void* data, int sizeInBytes) override;
 
+   #if MAKO_CLAP
+    //R1.01 CLAP parameter events come straight to us with their sample offset in the block.
+    bool supportsDirectEvent (uint16_t space_id, uint16_t type) override;
+    void handleDirectEvent (const clap_event_header_t* event, int sampleOffset) override;
+   #endif
+
     //R1.00 Add a Parameters variable.
     juce::AudioProcessorValueTreeState parameters;                           
     
     //R1.00 Our public variables.
-    int SettingsChanged = 0;
+    //R1.01 Editor and host threads add to it, the audio thread counts it down. Atomic so no change is lost.
+    std::atomic<int> SettingsChanged { 0 };
+    //R1.01 Set by setStateInformation. The audio thread picks it up and does a full Settings_Update.
+    std::atomic<bool> Settings_ForceReq { false };
     int SettingsType = 0;
     float Setting[30] = {};
     float Setting_Last[30] = {};
 
     int Pedal_Mono = 1;
+    int Pedal_Midi = 0;     //R1.01 Send the tracked pitch out as MIDI notes.
+    int Pedal_Governor = 0; //R1.01 Let the quality governor trade sound quality for CPU. See QUALITY GOVERNOR.
+
+    //R1.01 Load a WAVE file or a folder of WAVE files for the SAMPLE voice. Message thread only.
+    void SampleVoice_Load(const juce::File& Source);
+    static const int VOICE_Sample = 11;
+
+    //R1.01 RECORD AND REPLAY.
+    //R1.01 Record_Start makes the next prepareToPlay start a capture of every block into CaptureFile.
+    //R1.01 Setting MAKO_RECORD to a folder in the environment starts a new capture there at every prepareToPlay.
+    void Record_Start(const juce::File& CaptureFile);
+    void Record_Stop();
+
+    //R1.01 Used by the replay tool. Replay_Prepare goes before prepareToPlay, Replay_Block before each block.
+    void Replay_Prepare(const t_RecHeader& Hdr, const float* Settings, const float* Ratios);
+    void Replay_Block(const t_RecBlock& Blk, const float* Settings, const t_RecEvent* Events);
+
+   #if MAKO_REFERENCE_CHECK
+    //R1.01 Used by the equivalence tool. Reference_Set(true) runs the frozen scalar kernels instead of ours.
+    void Reference_Set(bool On) { Ref_On = On; }
+   #endif
+
+    //R1.01 The pitch the tracker is following on a channel in Hz. 0 = nothing tracked yet.
+    //R1.01 Used by the equivalence tool and the latency test. Call it from the thread running processBlock.
+    float Track_Freq(int channel) const;
+
+    //R1.01 Set the delay time multiplier for a channel (0.01 - 1.0). Delay Time * 2 * Ratio = echo time.
+    void Delay_SetChannelRatio(int channel, float Ratio);
+
+    //R1.01 Quality the governor has us running at (0 = full) and our last measured share of the real time
+    //R1.01 budget (1.0 = a block took as long to process as it lasts). Safe to read from any thread.
+    enum { e_Gov_Full, e_Gov_Osc, e_Gov_Boost, e_Gov_Analysis, e_Gov_Levels };
+    int Governor_Level() const { return Gov_Level.load(); }
+    float Governor_Load() const { return Gov_Load.load(); }
+    static const char* Governor_Name(int Level);
     
     //R1.00 These are the indexes into our Settings var.
     enum { e_Gain, e_Voice, e_Gliss, e_Mix, e_LP, e_Bal, e_Boost, e_PreGain, e_Attack, e_DTime, e_DLen, e_DMix };
@@ -73,45 +143,66 @@ public:
 private:
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MakoBiteAudioProcessor)
+
+    //R1.01 Tools/MakoLayout.cpp checks where our members sit in memory.
+    friend struct MakoLayout;
+
+    //R1.01 Longest segment processed at once. Sample accurate parameter grid size.
+    static const int SEGMENT_Size = 32;
+    static const int PARMEVENT_Max = 64;      //R1.01 Events in a block before changes to the same parameter are merged.
+    static const int PARM_Cnt = 12;
+    static const int PARM_Ratio = PARM_Cnt;   //R1.01 Event idx PARM_Ratio + channel sets that channel's Delay_Ratio.
    
     //R1.00 Functions to clean up parameter gets.
     int makoGetParmValue_int(juce::String Pstring);
     float makoGetParmValue_float(juce::String Pstring);
 
     //R1.00 We need a gain adjuster for BOOST.
-    float BOOST_Gain = 1.0f;
-
-    //R1.00 Balance settings are non linear so we need separate vars to track it.
-    float Pedal_Bal1LR[2] = { 1.0f, 1.0f };
-    float Pedal_Bal2LR[2] = { 1.0f, 1.0f };
-
-    //R1.00 This VST uses LOW PASS filters to try and get the guitar signal as close to a sine wave as possible.
-    //R1.00 We can then measure the period of the waveform to get the note being played. 
-    //R1.00 We measure as the signal goes from negative to positive.
-    int Mod_PitchCnt[2] = {  };       //R1.00 How many samples per Zero Crossing.
-    float Mod_PitchInc[2] = {  };     //R1.00 How many samples to make a SIN wave over.
-    float Mod_Sin[2] = {  };          //R1.00 Current angle of our sine wave generator. 
-    float Mod_Peak[2] = {  };         //R1.00 Need to track how loud the person is playing and scale our sig gen value to it.      
-    float Mod_LastSample[2] = {};     //R1.00 Store last vals so we can check if we are going NEG to POS.
-
-    //R1.00 These variables are used for the ATTACK envelope code.
-    float Signal_VolFade[2] = {};
-    float Signal_AVG[2] = {};
-    bool Signal_VolFadeOn[2] = { false, false };
-    bool Signal_VolFadeReset[2] = { false, false };
+    //R1.01 Makeup gain levels. See BOOST MAKEUP in MakoDSP.h.
+    std::vector<MakoDSP::t_BoostLevel> Boost_Level;   //R1.01 Per channel. Segment rate, so kept out of tp_chanstate.
+    bool Boost_Table = false;                 //R1.01 Governor: Boost uses our sine table instead of SINF.
+    void Mako_FX_Boost(float* Buf, int num, int channel);
 
     //R1.00 Digital Delay.
     float Delay_Dry = 1.0f;
     float Delay_Wet = 1.0f;
-    float Delay_B[2][192010] = { };   //R1.00 Delay Buffer. 1 second @ 192kHz sample rate. 
-    int Delay_B_Idx[2] = { };
-    int Delay_B_Idx_Max[2] = { };
+    std::vector<std::vector<float>> Delay_B;   //R1.01 Delay Buffer per channel. Sized for 2 seconds at our sample rate. 
+    std::vector<float> Delay_Ratio;            //R1.01 Delay time multiplier per channel. Default is L = 1.0, R = .5 for a stereo echo.
+    std::unique_ptr<std::atomic<float>[]> Delay_RatioReq;   //R1.01 Ratio asked for by Delay_SetChannelRatio. 0 = none.
+    bool Delay_Run = false;                    //R1.01 Delay Mix was up last time settings were checked.
+    void Delay_Clear();
+
+    //R1.01 BYPASS.
+    //R1.01 Host bypass crossfades from our sound to the dry signal over BYPASS_Fade samples, then
+    //R1.01 passes the audio straight through without touching it. Turning back on fades the other way.
+    static const int BYPASS_Fade = 256;
+    bool Bypass_On = false;
+    int Bypass_FadeCnt = 0;                    //R1.01 Fade samples left to do.
+    juce::AudioBuffer<float> Bypass_Dry;       //R1.01 Dry copy of the faded samples. Sized in prepareToPlay.
+
+    void Bypass_CopyDry(const juce::AudioBuffer<float>& buffer, int num);
+    void Bypass_Mix(juce::AudioBuffer<float>& buffer, int num, bool FadeIn);
 
     //R1.00 Some Constants and vars.
     const float pi = 3.14159265f;
     const float pi2 = 6.2831853f;
     const float sqrt2 = 1.4142135f;
-    float SampleRate = 48000.0f;
+    float SampleRate = 48000.0f;           //R1.01 Our internal processing rate. See INTERNAL RATE.
+
+    //R1.01 INTERNAL RATE.
+    //R1.01 Hosts running faster than INTERNAL_MaxRate get their audio halved Rate_Shift times, processed at
+    //R1.01 the lower rate and brought back up. 88.2k and 96k run at 44.1k and 48k, 176.4k and 192k and up too.
+    //R1.01 Our pitch tracker and synth were tuned at those rates and gain nothing from more samples.
+    //R1.01 The resampler adds latency, reported to the host with setLatencySamples.
+    static const int INTERNAL_MaxRate = 50000;
+    static const int INTERNAL_MinChunk = 2048;
+    int Rate_Shift = 0;                    //R1.01 Host rate = SampleRate << Rate_Shift. 0 = no resampling.
+    int Rate_Chunk = INTERNAL_MinChunk;    //R1.01 Most host samples resampled in one go.
+    MakoResampler Resampler;
+    juce::AudioBuffer<float> Rate_Buffer;  //R1.01 Internal rate audio. Sized in prepareToPlay.
+
+    void Mako_Rate(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages, bool Bypassed);
+    void Mako_Run(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages, bool Bypassed);
 
     //R1.00 OUR FILTER VARIABLES
     struct tp_coeffs {
@@ -132,34 +223,289 @@ private:
         float b2;
         float c0;
         float d0;
-        float xn0[2];
-        float xn1[2];
-        float xn2[2];
-        float yn1[2];
-        float yn2[2];
-        float offset[2];
+
+        //R1.01 Coefficient ramp. Coefficients move to Target in RampCnt segment steps.
+        tp_coeffs Target;
+        tp_coeffs Step;
+        int RampCnt;
+    };
+
+    //R1.01 Filter history. One per filter per channel, kept in our channel state.
+    struct tp_filterhist {
+        float xn1;
+        float xn2;
+        float yn1;
+        float yn2;
     };
 
     //R1.00 FILTERS
-    float Filter_Calc_BiQuad(float tSample, int channel, tp_filter* fn);
-    void Filter_BP_Coeffs(float Gain_dB, float Fc, float Q, tp_filter* fn);
-    void Filter_LP_Coeffs(float fc, tp_filter* fn);
-    void Filter_HP_Coeffs(float fc, tp_filter* fn);
+    float Filter_Calc_BiQuad(float tSample, tp_filterhist* hist, tp_filter* fn);
+    void Filter_BP_Coeffs(float Gain_dB, float Fc, float Q, tp_coeffs* cf);
+    void Filter_LP_Coeffs(float fc, tp_coeffs* cf);
+    void Filter_CoeffsFrom(const float* c, tp_coeffs* cf);
+    void Filter_HP_Coeffs(float fc, tp_coeffs* cf);
+    void Filter_SetCoeffs(const tp_coeffs* cf, tp_filter* fn, bool Ramp);
+    void Filter_RampStep(tp_filter* fn);
+
+    //R1.01 COEFFICIENT TABLES.
+    //R1.01 Every Low Pass setting (50 - 500 Hz in 1 Hz steps) is calculated once per sample rate in
+    //R1.01 prepareToPlay. Knob changes are a table lookup, no TANF on the audio thread.
+    static const int LP_Min = 50;
+    static const int LP_Max = 500;
+    static const int FILTER_RampSegs = 8;       //R1.01 Segments to glide to new coefficients. 256 samples.
+    struct tp_lptable {
+        tp_coeffs Coeffs[LP_Max - LP_Min + 1];
+    };
+    std::shared_ptr<const tp_lptable> Filter_LPTable;     //R1.01 Shared with every instance at our sample rate.
+    void Filter_BuildTables();
+
+    //R1.01 PITCH ANALYSIS FILTER CHAIN.
+    //R1.01 Only the pitch detector hears this chain. The more cleanly we get down to the fundamental,
+    //R1.01 the better the zero crossings track on bright pickups. The chain size is set here at compile time.
+    //R1.01   LoCut:  High Pass to remove DC and rumble.
+    //R1.01   HiCut:  ANALYSIS_LPStages Low Pass stages at the Low Pass knob. 1 = 2nd order (R1.00), 2 = 4th, 3 = 6th.
+    //R1.01   Emph:   Optional peaking boost to lift the fundamental region.
+    static const int ANALYSIS_LPStages = 2;
+    static const bool ANALYSIS_Emphasis = false;
+    const float ANALYSIS_LoCutFreq = 40.0f;
+    const float ANALYSIS_EmphFreq = 150.0f;
+    const float ANALYSIS_EmphGain_dB = 6.0f;
+    const float ANALYSIS_EmphQ = 1.0f;
 
     //R1.00 Our filters and function def.
-    tp_filter makoF_HiCut1 = {};
-    tp_filter makoF_HiCut2 = {};
+    tp_filter makoF_HiCut[ANALYSIS_LPStages] = {};
     tp_filter makoF_LoCut = {};
+    tp_filter makoF_Emph = {};
+
+    //R1.01 Filter history slots in tp_chanstate. Same order the chain runs in.
+    static const int FILT_LoCut = 0;
+    static const int FILT_HiCut = 1;
+    static const int FILT_Emph = FILT_HiCut + ANALYSIS_LPStages;
+    static const int FILT_Cnt = FILT_Emph + 1;
+
+    //R1.01 Low Pass stages actually run. The governor drops this to 1 when the CPU is short.
+    int Analysis_LPRun = ANALYSIS_LPStages;
+
+    //R1.01 Runs the whole analysis chain over a segment in one pass.
+    void Filter_Analysis_Block(const float* Src, float* Dest, int num, int channel);
+
+    //R1.01 Block kernels for this CPU. See MakoKernels.h.
+    const t_MakoKernels* Kern = nullptr;
     
+    //R1.01 PER CHANNEL STATE.
+    //R1.01 Everything the inner loops change for one channel lives in one small struct. Each channel
+    //R1.01 starts on its own cache line, so a channel's working set is two cache lines and channels never
+    //R1.01 share a line. Settings, tables, delay buffers and the APVTS are kept out of here.
+    //R1.01 Sized in prepareToPlay for however many channels the host gives us.
+    //R1.01 This is one struct per channel (array of structs), not one array per variable. Channels are not
+    //R1.01 run as SIMD lanes: the tracker branches on every zero crossing and each channel has its own delay
+    //R1.01 length. The block kernels (MakoKernels) vectorize along the samples of one channel instead.
+    //R1.01 MakoEngine, which does run tracks as lanes, keeps its state as arrays per variable.
+    struct alignas(64) tp_chanstate {
+        //R1.00 This VST uses LOW PASS filters to try and get the guitar signal as close to a sine wave as possible.
+        //R1.00 We can then measure the period of the waveform to get the note being played. 
+        //R1.00 We measure as the signal goes from negative to positive.
+        juce::uint32 Mod_Phase = 0;          //R1.01 Current angle of our sine wave generator. 0 - 2^32 = 0 - 4PI. Wraps for free.
+        juce::uint32 Mod_PhaseInc = 0;       //R1.01 Mod_PitchInc in phase units.
+        int Mod_PitchCnt = 0;                //R1.00 How many samples per Zero Crossing.
+        float Mod_PitchInc = 0.0f;           //R1.00 How many samples to make a SIN wave over.
+        float Mod_Peak = 0.0f;               //R1.00 Need to track how loud the person is playing and scale our sig gen value to it.
+        float Mod_LastSample = 0.0f;         //R1.00 Store last vals so we can check if we are going NEG to POS.
+
+        //R1.00 Balance settings are non linear so we need separate vars to track it.
+        //R1.01 Even channels are treated as LEFT and odd channels as RIGHT.
+        float Pedal_Bal1LR = 1.0f;
+
+        //R1.00 These variables are used for the ATTACK envelope code.
+        float Signal_VolFade = 0.0f;
+        float Signal_AVG = 0.0f;
+        char Signal_VolFadeOn = 0;
+
+        //R1.01 Stages that ran last segment. A stage that was skipped is cleared when it starts again.
+        char Attack_Run = 0;
+        char Track_Run = 0;
+
+        //R1.00 Digital Delay read/write position.
+        int Delay_B_Idx = 0;
+        int Delay_B_Idx_Max = 0;
+
+        //R1.01 Pitch analysis filter history.
+        tp_filterhist Filt[FILT_Cnt] = {};
+
+        //R1.01 Sample voice playback.
+        double Sample_Pos = 0.0;             //R1.01 Play position in file samples.
+        float Sample_Step = 0.0f;            //R1.01 File samples per output sample.
+        int Sample_Zone = -1;                //R1.01 Zone being played. -1 = pick at the next zero crossing.
+    };
+
+    //R1.01 Catch anything that makes a channel spill onto another cache line.
+    //R1.01 Two lines with up to 2 Low Pass stages, a third line for 3 stages.
+    static const int CHAN_Lines = (ANALYSIS_LPStages <= 2) ? 2 : 3;
+    static_assert(alignof(tp_chanstate) == 64, "tp_chanstate must start on a cache line");
+    static_assert(sizeof(tp_chanstate) <= 64 * CHAN_Lines, "tp_chanstate has grown past its cache lines");
+
+    std::vector<tp_chanstate> Chan_State;
+    int Chan_Cnt = 0;
+    void Channels_Resize(int Channels);
+
+    //R1.01 ENVELOPE FOLLOWERS.
+    //R1.01 One pole followers with their coefficient made from a time in milliseconds and the real
+    //R1.01 sample rate. CoefPow holds Coef^N so a whole segment can be updated in one step.
+    struct tp_envelope {
+        float Coef;
+        float CoefPow[SEGMENT_Size + 1];
+    };
+
+    //R1.01 Time constants are in MakoDSP.h.
+    tp_envelope Env_Peak = {};
+    tp_envelope Env_Avg = {};
+    tp_envelope Env_FadeOut = {};
+    tp_envelope Env_Boost = {};
+    float Attack_Inc = 0.0f;                  //R1.01 Attack fade in amount per sample.
+
+    void Envelope_Coeffs(float ms, tp_envelope* env);
+    void Attack_CalcSettings(bool ForceAll);
+
     void Balance_CalcSettings(bool ForceAll);
     void Filter_CalcSettings(bool ForceAll);
     void Mako_Update_Delay(bool ForceAll);
 
-    float Mako_FX_MonoToneSyn(float tSample, int channel);
-    float Mako_FX_Attack(float tSample, int channel);
-    float Mako_FX_Delay(float tSample, int channel);
+    float Mako_FX_MonoToneSyn(float tSample, float tAnalysis, int channel);
+
+    //R1.01 OSCILLATOR CORE. The oscillators and voices are in MakoDSP.h.
+    const float* SIN_Table = nullptr;                        //R1.01 Points into the shared tables.
+    bool Osc_Nearest = false;                                //R1.01 Governor: nearest table entry, no interpolation.
+
+    //R1.01 Tables shared with every other instance in the process.
+    juce::SharedResourcePointer<MakoSharedTables> Shared;
+
+   #if MAKO_TRACE
+    //R1.01 Trace file writer. Shared by every instance so they all land on one timeline.
+    juce::SharedResourcePointer<MakoTrace::Writer> TraceWriter;
+   #endif
+
+    //R1.01 SAMPLE VOICE.
+    //R1.01 WAVE files played back at the tracked pitch. Single cycles follow our oscillator phase.
+    //R1.01 Longer zones are resampled with a step of tracked pitch / root pitch.
+    MakoSampleLoader SampleLoader;
+    MakoSampleSet* Sample_Active = nullptr;   //R1.01 Audio thread only. Play positions are in tp_chanstate.
+
+    void Sample_PitchDetected(int channel);
+    float Sample_Render(int channel);
+
+    //R1.01 PITCH TO MIDI.
+    //R1.01 Channel 0 pitch and level are turned into note on/off and pitch bend messages.
+    //R1.01 Events are written at the sample where the zero crossing was found.
+    const float MIDI_GateOn = .1f;         //R1.01 Mod_Peak level to start a note.
+    const float MIDI_GateOff = .05f;       //R1.01 Mod_Peak level to end a note. Lower than GateOn for hysteresis.
+    const float MIDI_NoteHyst = .75f;      //R1.01 Semitones away from the current note before we retrigger.
+    const float MIDI_BendRange = 2.0f;     //R1.01 Semitones for full pitch bend. Must match the synth.
+    const int MIDI_Channel = 1;
+
+    const int MIDI_ReserveBytes = 4096;    //R1.01 Room for a few hundred messages per block.
+
+    juce::MidiBuffer* Midi_Out = nullptr;  //R1.01 Only valid during processBlock.
+    juce::MidiBuffer Midi_Work;            //R1.01 Our messages for this block. Sized in prepareToPlay, never grows on the audio thread.
+    int Midi_Offset = 0;                   //R1.01 Sample in the host block being processed.
+    int Midi_Base = 0;                     //R1.01 Host sample where the current internal rate chunk starts.
+    int Midi_Last = 0;                     //R1.01 Last host sample of the current chunk.
+    int Midi_Note = -1;                    //R1.01 Note currently on. -1 = none.
+    int Midi_Bend = 8192;
+    int Midi_NewNoteCnt = 0;               //R1.01 Crossings in a row that wanted a different note.
+
+    void Midi_Flush(juce::MidiBuffer& midiMessages);
+    void Midi_PitchDetected(int channel);
+    void Midi_CheckGate(int channel);
+    void Midi_NoteOff(int offset);
+
+    //R1.01 Internal rate sample to host block sample for our MIDI events.
+    inline int Midi_HostOffset(int samp) const { return juce::jmin(Midi_Base + (samp << Rate_Shift), Midi_Last); }
+    void Mako_FX_Attack(const float* Src, float* Dest, int num, int channel);
+    void Mako_FX_Delay_Block(float* Buf, int num, int channel);
 
     //R1.00 Handle any paramater changes.
     void Settings_Update(bool ForceAll);
+
+    //R1.01 SAMPLE ACCURATE PARAMETERS.
+    //R1.01 Parameter changes are queued as events with a sample offset into the current block.
+    //R1.01 The block is split at each event and at a fixed sample grid, and our derived settings
+    //R1.01 (filters, delay, balance) are only recalculated at those split points.
+    struct tp_parmevent {
+        int offset;
+        int idx;
+        float value;
+    };
+
+    std::vector<tp_parmevent> Parm_Events;     //R1.01 PARMEVENT_Max + one per event idx. Sized in Channels_Resize.
+    int Parm_EventCnt = 0;
+    bool Settings_Force = false;       //R1.01 This block starts with a full Settings_Update. Captures record it.
+    juce::int64 Segment_Clock = 0;     //R1.01 Total samples processed. Keeps our split grid fixed no matter the host block size.
+
+    //R1.01 Direct pointers to the APVTS values so we can poll host automation without string lookups.
+    std::atomic<float>* Parm_Raw[PARM_Cnt] = {};
+    std::atomic<float>* Parm_RawMono = nullptr;
+    juce::RangedAudioParameter* Parm_Ptr[PARM_Cnt] = {};
+
+    std::atomic<float>* Parm_RawMidi = nullptr;
+    std::atomic<float>* Parm_RawGovernor = nullptr;
+
+    void Parm_QueueEvent(int offset, int idx, float value);
+    void Parm_Apply(int idx, float value);
+    void Parm_PollHost();
+    void Parm_Defer(int ev);
+
+    //R1.01 QUALITY GOVERNOR.
+    //R1.01 When the governor switch is on, every processBlock is timed against how long the block lasts.
+    //R1.01 Over each GOV_Window_ms of audio, a load above GOV_StepDown drops us one quality level. Load has
+    //R1.01 to stay under GOV_StepUp for GOV_UpWindows windows in a row before we go back up one. The gap
+    //R1.01 between them is wider than what a level saves, so we never bounce between two levels.
+    //R1.01   e_Gov_Osc:      Oscillator sines use the nearest table entry, no interpolation.
+    //R1.01   e_Gov_Boost:    Boost uses the sine table instead of SINF.
+    //R1.01   e_Gov_Analysis: Pitch analysis runs one Low Pass stage instead of ANALYSIS_LPStages.
+    //R1.01 A switched off governor always runs at full quality. Replays run each block at the level it was recorded at.
+    const float GOV_Window_ms = 100.0f;
+    const float GOV_StepDown = .70f;
+    const float GOV_StepUp = .30f;
+    static const int GOV_UpWindows = 20;
+    double Gov_HostRate = 48000.0;
+    double Gov_TickRate = 1.0;                 //R1.01 High resolution ticks per second.
+    int Gov_WindowLen = 4800;                  //R1.01 Host samples per window.
+    juce::int64 Gov_Ticks = 0;                 //R1.01 Time spent in this window.
+    int Gov_Samples = 0;                       //R1.01 Host samples in this window.
+    int Gov_Calm = 0;                          //R1.01 Windows in a row under GOV_StepUp.
+
+    //R1.01 The editor timer reads these. They get a cache line to themselves so those reads never slow
+    //R1.01 the Gov_ counters above, which the audio thread writes every block. Tools/MakoLayout.cpp checks it.
+    alignas(64) std::atomic<int> Gov_Level { e_Gov_Full };
+    std::atomic<float> Gov_Load { 0.0f };
+    char Gov_Pad[64 - sizeof(std::atomic<int>) - sizeof(std::atomic<float>)] = {};
+
+    void Governor_Update(juce::int64 Start, int num);
+    void Governor_Apply(int Level);
+
+    //R1.01 Capture of our input for offline replay. Off unless asked for.
+    MakoRecorder Recorder;
+    juce::File Record_File;
+    bool Replay_On = false;
+
+    void Record_Header(int samplesPerBlock);
+    void Record_Block(const juce::AudioBuffer<float>& buffer, int Type);
+    void Mako_ProcessBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages);
+    void Mako_ProcessSegment(juce::AudioBuffer<float>& buffer, int start, int num);
+
+   #if MAKO_REFERENCE_CHECK
+    //R1.01 REFERENCE MODEL. Frozen copy of the scalar code as it was before any optimization.
+    //R1.01 Do not change these. They are what optimized kernels are measured against.
+    bool Ref_On = false;
+    float Ref_Calc_BiQuad(float tSample, tp_filterhist* hist, const tp_filter* fn);
+    void Ref_Analysis_Block(const float* Src, float* Dest, int num, int channel);
+    std::vector<double> Ref_Phase;         //R1.01 Reference synth phase in radians, 0 to 4PI. Per channel.
+    std::vector<double> Ref_Step;          //R1.01 Reference phase step per sample.
+    void Ref_Segment(float* channelData, int start, int num, int channel, bool AttackOn, bool TrackOn, bool SynthOn);
+    void Ref_FX_Attack(float* Buf, int num, int channel);
+    float Ref_FX_MonoToneSyn(float tSample, float tAnalysis, int channel);
+    void Ref_FX_Boost(float* Buf, int num, int channel);
+    float Ref_FX_Delay(float tSample, int channel);
+   #endif
         
 };
@@ -0,0 +1,211 @@
+/*
+  ==============================================================================
+
+    MakoPy.cpp
+    Python module for the MonoTone DSP (MakoEngine). Processes NumPy arrays
+    in place and lets go of the GIL while it runs.
+
+    There is no setup.py or pyproject.toml. Build it by hand with pybind11,
+    from the project folder, for example:
+      c++ -O2 -shared -std=c++17 -fPIC $(python3 -m pybind11 --includes)
+          Python/MakoPy.cpp MakoEngine.cpp MakoDSP.cpp -I. -o makotone$(python3-config --extension-suffix)
+    Add MakoBounds.cpp and -DMAKO_BOUNDS_CHECK=1 for the buffer range checks.
+
+    Not exposed: the sample voice (11) needs JUCE to read WAVE files and
+    MakoEngine has no JUCE. Balance is a left/right control and every track
+    here is mono, so scale the rows in NumPy instead.
+
+  ==============================================================================
+*/
+
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <pybind11/stl.h>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include "../MakoEngine.h"
+
+namespace py = pybind11;
+
+//R1.01 float64 audio is converted through a small buffer per track, this many samples at a time.
+static const int PY_Chunk = 4096;
+
+//R1.01 One Python Engine is one MakoEngine. Tracks = rows of the array passed to process.
+class MakoPyEngine
+{
+public:
+    MakoPyEngine(int Tracks, double SampleRate)
+    {
+        if (Tracks < 1) throw std::invalid_argument("tracks must be 1 or more");
+        Eng.Prepare(Tracks, SampleRate);
+        Parms.assign(size_t(Tracks), MakoEngine::t_Parms());
+        Rate = SampleRate;
+    }
+
+    //R1.01 Any settings not named keep their current value.
+    void Parms_Set(int e, const py::kwargs& kw)
+    {
+        Track_Check(e);
+        MakoEngine::t_Parms P = Parms[e];
+        for (auto item : kw)
+        {
+            std::string Name = py::str(item.first);
+            py::handle v = item.second;
+            if (Name == "gain") P.Gain = v.cast<float>();
+            else if (Name == "voice") P.Voice = v.cast<int>();
+            else if (Name == "gliss") P.Gliss = v.cast<float>();
+            else if (Name == "mix") P.Mix = v.cast<float>();
+            else if (Name == "lp") P.LP = v.cast<float>();
+            else if (Name == "boost") P.Boost = v.cast<float>();
+            else if (Name == "pregain") P.PreGain = v.cast<float>();
+            else if (Name == "attack") P.Attack = v.cast<float>();
+            else if (Name == "dtime") P.DTime = v.cast<float>();
+            else if (Name == "dlen") P.DLen = v.cast<float>();
+            else if (Name == "dmix") P.DMix = v.cast<float>();
+            else throw py::key_error("unknown setting: " + Name);
+        }
+
+        //R1.01 Let go of the GIL before waiting for a process call on another thread to finish.
+        py::gil_scoped_release NoGil;
+        std::lock_guard<std::mutex> Lock(Busy);
+        Parms[e] = P;
+        Eng.Parms_Set(e, P);
+    }
+
+    py::dict Parms_Get(int e)
+    {
+        Track_Check(e);
+        MakoEngine::t_Parms P;
+        {
+            py::gil_scoped_release NoGil;
+            std::lock_guard<std::mutex> Lock(Busy);
+            P = Parms[e];
+        }
+
+        py::dict d;
+        d["gain"] = P.Gain; d["voice"] = P.Voice; d["gliss"] = P.Gliss; d["mix"] = P.Mix; d["lp"] = P.LP;
+        d["boost"] = P.Boost; d["pregain"] = P.PreGain; d["attack"] = P.Attack;
+        d["dtime"] = P.DTime; d["dlen"] = P.DLen; d["dmix"] = P.DMix;
+        return d;
+    }
+
+    void Reset(int e)
+    {
+        Track_Check(e);
+        py::gil_scoped_release NoGil;
+        std::lock_guard<std::mutex> Lock(Busy);
+        Eng.Reset(e);
+    }
+
+    float Track_Freq(int e)
+    {
+        Track_Check(e);
+        py::gil_scoped_release NoGil;
+        std::lock_guard<std::mutex> Lock(Busy);
+        return Eng.Track_Freq(e);
+    }
+
+    //R1.01 Audio is shape (samples) with one track, or (tracks, samples). float32 or float64, written in place.
+    //R1.01 Each row must have contiguous samples. Rows can be anywhere (slices and views are fine).
+    void Process(py::array Audio)
+    {
+        if (!Audio.writeable()) throw std::invalid_argument("audio array is read only");
+        if ((Audio.ndim() != 1) && (Audio.ndim() != 2)) throw std::invalid_argument("audio must be 1D (samples) or 2D (tracks, samples)");
+
+        int Tracks = (Audio.ndim() == 1) ? 1 : int(Audio.shape(0));
+        py::ssize_t num = Audio.shape(Audio.ndim() - 1);
+        if (Tracks != Eng.Engines_Get()) throw std::invalid_argument("array has " + std::to_string(Tracks) + " tracks, engine has " + std::to_string(Eng.Engines_Get()));
+
+        bool F32 = py::isinstance<py::array_t<float>>(Audio);
+        bool F64 = py::isinstance<py::array_t<double>>(Audio);
+        if (!F32 && !F64) throw std::invalid_argument("audio must be float32 or float64");
+        if ((1 < num) && (Audio.strides(Audio.ndim() - 1) != Audio.itemsize())) throw std::invalid_argument("samples in each track must be contiguous");
+
+        char* Base = static_cast<char*>(Audio.mutable_data());
+        py::ssize_t RowStride = (Audio.ndim() == 1) ? 0 : Audio.strides(0);
+
+        //R1.01 Audio keeps the array alive. Nothing below touches Python objects.
+        py::gil_scoped_release NoGil;
+        std::lock_guard<std::mutex> Lock(Busy);
+
+        if (F32)
+        {
+            //R1.01 float32 goes straight to the engine. No copies.
+            Rows.resize(size_t(Tracks));
+            for (int e = 0; e < Tracks; e++) Rows[e] = reinterpret_cast<float*>(Base + e * RowStride);
+
+            //R1.01 Process takes an int count. Huge arrays go through in pieces.
+            for (py::ssize_t pos = 0; pos < num; )
+            {
+                int n = int(std::min<py::ssize_t>(num - pos, 1 << 30));
+                Eng.Process(Rows.data(), n);
+                for (int e = 0; e < Tracks; e++) Rows[e] += n;
+                pos += n;
+            }
+            return;
+        }
+
+        //R1.01 float64 is not zero copy. The engine runs in float32, so each chunk is copied into a float32
+        //R1.01 buffer, processed, and copied back in place. Pass float32 to skip the copies.
+        Work.resize(size_t(Tracks) * PY_Chunk);
+        Rows.resize(size_t(Tracks));
+        for (int e = 0; e < Tracks; e++) Rows[e] = Work.data() + size_t(e) * PY_Chunk;
+
+        for (py::ssize_t pos = 0; pos < num; pos += PY_Chunk)
+        {
+            int n = int(std::min<py::ssize_t>(PY_Chunk, num - pos));
+            for (int e = 0; e < Tracks; e++)
+            {
+                const double* Src = reinterpret_cast<const double*>(Base + e * RowStride) + pos;
+                for (int t = 0; t < n; t++) Rows[e][t] = float(Src[t]);
+            }
+
+            Eng.Process(Rows.data(), n);
+
+            for (int e = 0; e < Tracks; e++)
+            {
+                double* Dest = reinterpret_cast<double*>(Base + e * RowStride) + pos;
+                for (int t = 0; t < n; t++) Dest[t] = Rows[e][t];
+            }
+        }
+    }
+
+    int Tracks_Get() const { return Eng.Engines_Get(); }
+    double Rate_Get() const { return Rate; }
+
+private:
+    MakoEngine Eng;
+    std::vector<MakoEngine::t_Parms> Parms;
+    double Rate = 48000.0;
+
+    //R1.01 Held while an engine runs or its settings change. The same Engine used from two threads takes turns.
+    //R1.01 Always taken with the GIL released, so a thread waiting here never blocks the others.
+    std::mutex Busy;
+    std::vector<float*> Rows;
+    std::vector<float> Work;
+
+    void Track_Check(int e) const
+    {
+        if ((e < 0) || (int(Parms.size()) <= e)) throw py::index_error("track " + std::to_string(e) + " out of range");
+    }
+};
+
+PYBIND11_MODULE(makotone, m)
+{
+    m.doc() = "MonoTone pitch tracking synth. Engines process NumPy float32/float64 audio in place without the GIL.";
+
+    py::class_<MakoPyEngine>(m, "Engine")
+        .def(py::init<int, double>(), py::arg("tracks") = 1, py::arg("rate") = 48000.0)
+        .def("set", &MakoPyEngine::Parms_Set, py::arg("track") = 0,
+            "Change settings: gain, voice (0-10), gliss, mix, lp (50-500 Hz), boost, pregain, attack, dtime, dlen, dmix.")
+        .def("get", &MakoPyEngine::Parms_Get, py::arg("track") = 0)
+        .def("reset", &MakoPyEngine::Reset, py::arg("track") = 0, "Clear filters, tracker, envelopes and delay.")
+        .def("track_freq", &MakoPyEngine::Track_Freq, py::arg("track") = 0, "Pitch being tracked in Hz. 0 = none yet.")
+        .def("process", &MakoPyEngine::Process, py::arg("audio"),
+            "Process audio in place. Shape (samples) or (tracks, samples), float32 (no copy) or float64 (copied through float32 in chunks).")
+        .def_property_readonly("tracks", &MakoPyEngine::Tracks_Get)
+        .def_property_readonly("rate", &MakoPyEngine::Rate_Get);
+
+    m.attr("VOICES") = 10;
+}
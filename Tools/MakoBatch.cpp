@@ -0,0 +1,407 @@
+/*
+  ==============================================================================
+
+    MakoBatch.cpp
+    Console tool. Renders a folder (or a manifest) of audio files through the
+    processor with one or more presets, using every core.
+
+    Build as a JUCE console application with the same source files and
+    BinaryData as the plugin. The editor is linked in but never opened.
+
+    Usage: MakoBatch input_folder|manifest.txt out_folder [-preset file]... [-threads n] [-chunk n] [-bits 16|24|32]
+
+    Manifest: one job per line, "input [preset]". Paths are relative to the manifest, and outputs keep
+    the same relative path under out_folder. # starts a comment.
+    Preset: one setting per line, "parameter_id value", for example "voice 3" or "boost .4". Settings not
+    named stay at their defaults.
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../PluginProcessor.h"
+
+//R1.01 A named set of parameter values.
+struct t_BatchPreset {
+    juce::String Name;
+    std::vector<std::pair<juce::String, float>> Values;
+};
+
+//R1.01 One input file rendered with one preset. The worker that runs it fills in the result.
+struct t_BatchJob {
+    juce::File In;
+    juce::File Out;
+    int Preset = 0;
+
+    bool Done = false;
+    juce::String Error;
+    juce::int64 Samples = 0;        //R1.01 Sample frames written.
+    int Channels = 0;
+    double Rate = 0.0;
+    juce::int64 Bytes = 0;          //R1.01 Input file size.
+    double Ms = 0.0;
+};
+
+//R1.01 Everything the workers share. Jobs are only written by the worker that took them.
+struct t_BatchRun {
+    std::vector<t_BatchJob> Jobs;
+    std::vector<t_BatchPreset> Presets;
+    std::atomic<int> Next { 0 };
+    int Chunk = 65536;
+    int Bits = 24;
+    juce::CriticalSection PrintLock;
+};
+
+static const char* BATCH_Usage = "Usage: MakoBatch input_folder|manifest.txt out_folder [-preset file]... [-threads n] [-chunk n] [-bits 16|24|32]";
+static const char* BATCH_Wildcard = "*.wav;*.aif;*.aiff;*.flac";
+
+static bool Batch_LoadPreset(const juce::File& File, t_BatchPreset& Preset, juce::String& Error)
+{
+    if (!File.existsAsFile())
+    {
+        Error = "Can not open preset " + File.getFullPathName();
+        return false;
+    }
+
+    Preset.Name = File.getFileNameWithoutExtension();
+    juce::StringArray Lines;
+    File.readLines(Lines);
+    for (int t = 0; t < Lines.size(); t++)
+    {
+        juce::String Line = Lines[t].upToFirstOccurrenceOf("#", false, false).trim();
+        if (Line.isEmpty()) continue;
+
+        juce::StringArray Tok = juce::StringArray::fromTokens(Line, " \t=", "\"");
+        Tok.removeEmptyStrings();
+        if (Tok.size() != 2)
+        {
+            Error = File.getFileName() + " line " + juce::String(t + 1) + ": expected \"parameter_id value\"";
+            return false;
+        }
+        Preset.Values.push_back({ Tok[0], Tok[1].getFloatValue() });
+    }
+    return true;
+}
+
+//R1.01 Every setting back to its default, then the preset on top. Picked up by prepareToPlay.
+static void Batch_ApplyPreset(MakoBiteAudioProcessor& Proc, const t_BatchPreset& Preset)
+{
+    for (auto* p : Proc.getParameters())
+        if (auto* rp = dynamic_cast<juce::RangedAudioParameter*>(p)) rp->setValueNotifyingHost(rp->getDefaultValue());
+
+    for (auto& v : Preset.Values)
+        if (auto* p = Proc.parameters.getParameter(v.first)) p->setValueNotifyingHost(p->convertTo0to1(v.second));
+}
+
+//R1.01 Stream one file through the processor, Chunk samples at a time. Memory use does not depend on file length.
+static void Batch_Render(MakoBiteAudioProcessor& Proc, juce::AudioFormatManager& Formats, juce::AudioBuffer<float>& Buf, t_BatchRun& Run, t_BatchJob& Job)
+{
+    double Start = juce::Time::getMillisecondCounterHiRes();
+
+    std::unique_ptr<juce::AudioFormatReader> Reader(Formats.createReaderFor(Job.In));
+    if (Reader == nullptr)
+    {
+        Job.Error = "can not read";
+        return;
+    }
+
+    Job.Channels = int(Reader->numChannels);
+    Job.Rate = Reader->sampleRate;
+    Job.Bytes = Job.In.getSize();
+    juce::int64 Len = Reader->lengthInSamples;
+
+    Job.Out.getParentDirectory().createDirectory();
+    Job.Out.deleteFile();
+    juce::WavAudioFormat Wav;
+    std::unique_ptr<juce::AudioFormatWriter> Writer(Wav.createWriterFor(new juce::FileOutputStream(Job.Out), Job.Rate, juce::uint32(Job.Channels), Run.Bits, {}, 0));
+    if (Writer == nullptr)
+    {
+        Job.Error = "can not write " + Job.Out.getFullPathName();
+        return;
+    }
+
+    //R1.01 prepareToPlay clears every filter, envelope and delay line so jobs never leak into each other.
+    Batch_ApplyPreset(Proc, Run.Presets[size_t(Job.Preset)]);
+    Proc.setPlayConfigDetails(Job.Channels, Job.Channels, Job.Rate, Run.Chunk);
+    Proc.prepareToPlay(Job.Rate, Run.Chunk);
+
+    //R1.01 At high rates the processor has resampler latency. Drop that much from the front and run the
+    //R1.01 same amount of silence in at the end, so the output lines up with the input and has the same length.
+    juce::int64 Skip = Proc.getLatencySamples();
+    juce::int64 Total = Len + Skip;
+    juce::MidiBuffer Midi;
+
+    for (juce::int64 Pos = 0; Pos < Total; )
+    {
+        int n = int(juce::jmin<juce::int64>(Run.Chunk, Total - Pos));
+        Buf.setSize(Job.Channels, n, false, false, true);
+        Buf.clear();
+        if (Pos < Len) Reader->read(&Buf, 0, int(juce::jmin<juce::int64>(n, Len - Pos)), Pos, true, true);
+
+        Midi.clear();
+        Proc.processBlock(Buf, Midi);
+
+        int Drop = int(juce::jmin<juce::int64>(Skip, n));
+        Skip -= Drop;
+        if (Drop < n) Writer->writeFromAudioSampleBuffer(Buf, Drop, n - Drop);
+        Job.Samples += n - Drop;
+        Pos += n;
+    }
+
+    Proc.releaseResources();
+    Job.Done = true;
+    Job.Ms = juce::Time::getMillisecondCounterHiRes() - Start;
+}
+
+//R1.01 WORKER. Owns its processor, reader formats and chunk buffer. Takes the next job until none are left,
+//R1.01 so a worker that drew short files simply takes more of them.
+class MakoBatchWorker : public juce::Thread
+{
+public:
+    MakoBatchWorker(int Id, t_BatchRun& BatchRun) : juce::Thread("Mako Batch " + juce::String(Id)), Run(BatchRun) {}
+
+    int Jobs = 0;
+    double BusyMs = 0.0;
+
+    void run() override
+    {
+        auto Proc = std::make_unique<MakoBiteAudioProcessor>();
+        juce::AudioFormatManager Formats;
+        Formats.registerBasicFormats();
+        juce::AudioBuffer<float> Buf;
+
+        while (!threadShouldExit())
+        {
+            int j = Run.Next.fetch_add(1);
+            if (int(Run.Jobs.size()) <= j) break;
+
+            t_BatchJob& Job = Run.Jobs[size_t(j)];
+            Batch_Render(*Proc, Formats, Buf, Run, Job);
+            Jobs++;
+            BusyMs += Job.Ms;
+
+            const juce::ScopedLock sl(Run.PrintLock);
+            std::cout << "[" << j + 1 << "/" << Run.Jobs.size() << "] " << Job.In.getFileName() << " + "
+                      << Run.Presets[size_t(Job.Preset)].Name << ": ";
+            if (Job.Done)
+                std::cout << (double(Job.Samples) / Job.Rate) << " s in " << (Job.Ms * .001) << " s" << std::endl;
+            else
+                std::cout << "FAILED, " << Job.Error << std::endl;
+        }
+    }
+
+private:
+    t_BatchRun& Run;
+};
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI JuceInit;
+
+    if (argc < 3)
+    {
+        std::cout << BATCH_Usage << std::endl;
+        return 1;
+    }
+
+    juce::File Cwd = juce::File::getCurrentWorkingDirectory();
+    juce::File Source = Cwd.getChildFile(argv[1]);
+    juce::File OutDir = Cwd.getChildFile(argv[2]);
+
+    t_BatchRun Run;
+    int Threads = juce::SystemStats::getNumCpus();
+    juce::StringArray PresetFiles;
+
+    for (int a = 3; a < argc; a += 2)
+    {
+        juce::String Arg(argv[a]);
+        if (argc <= a + 1)
+        {
+            std::cout << BATCH_Usage << std::endl;
+            return 1;
+        }
+        juce::String Val(argv[a + 1]);
+        if (Arg == "-preset") PresetFiles.add(Val);
+        else if (Arg == "-threads") Threads = juce::jmax(1, Val.getIntValue());
+        else if (Arg == "-chunk") Run.Chunk = juce::jlimit(256, 1 << 22, Val.getIntValue());
+        else if (Arg == "-bits") Run.Bits = Val.getIntValue();
+        else
+        {
+            std::cout << BATCH_Usage << std::endl;
+            return 1;
+        }
+    }
+    if ((Run.Bits != 16) && (Run.Bits != 24) && (Run.Bits != 32))
+    {
+        std::cout << "-bits must be 16, 24 or 32." << std::endl;
+        return 1;
+    }
+
+    //R1.01 PRESETS. With none given every file is rendered once with the default settings.
+    juce::String Error;
+    for (auto& Name : PresetFiles)
+    {
+        t_BatchPreset P;
+        if (!Batch_LoadPreset(Cwd.getChildFile(Name), P, Error))
+        {
+            std::cout << Error << std::endl;
+            return 1;
+        }
+        Run.Presets.push_back(P);
+    }
+
+    //R1.01 JOBS. A folder is every audio file under it times every preset. Sub folders are kept in the output.
+    //R1.01 Every input is found first, so whether names need a preset suffix is known before any job is made.
+    if (Run.Presets.empty()) Run.Presets.push_back({ "default", {} });
+    const int CmdPresets = int(Run.Presets.size());
+
+    struct t_BatchInput {
+        juce::File In;
+        juce::String Rel;      //R1.01 Path relative to the folder or manifest. Output goes to the same place under out_folder.
+        int Preset;            //R1.01 -1 = every -preset.
+    };
+    std::vector<t_BatchInput> Inputs;
+
+    if (Source.isDirectory())
+    {
+        auto Files = Source.findChildFiles(juce::File::findFiles, true, BATCH_Wildcard);
+        std::sort(Files.begin(), Files.end());
+        for (auto& f : Files) Inputs.push_back({ f, f.getRelativePathFrom(Source), -1 });
+    }
+    else if (Source.existsAsFile())
+    {
+        //R1.01 MANIFEST. A job line can name its own preset, otherwise it gets every -preset.
+        juce::StringArray Lines;
+        Source.readLines(Lines);
+        juce::File Base = Source.getParentDirectory();
+        for (int t = 0; t < Lines.size(); t++)
+        {
+            juce::String Line = Lines[t].upToFirstOccurrenceOf("#", false, false).trim();
+            if (Line.isEmpty()) continue;
+
+            juce::StringArray Tok = juce::StringArray::fromTokens(Line, " \t", "\"");
+            Tok.removeEmptyStrings();
+            for (auto& s : Tok) s = s.unquoted();
+            juce::File In = Base.getChildFile(Tok[0]);
+
+            //R1.01 Keep the manifest's folders in the output so files with the same name do not collide.
+            //R1.01 Files above the manifest folder get "_up" for each "..", so they stay under out_folder.
+            juce::StringArray Parts = juce::StringArray::fromTokens(In.getRelativePathFrom(Base), "/\\", "");
+            for (auto& Part : Parts)
+                if (Part == "..") Part = "_up";
+            juce::String Rel = Parts.joinIntoString("/");
+
+            int Preset = -1;
+            if (1 < Tok.size())
+            {
+                t_BatchPreset P;
+                if (!Batch_LoadPreset(Base.getChildFile(Tok[1]), P, Error))
+                {
+                    std::cout << Error << std::endl;
+                    return 1;
+                }
+                Run.Presets.push_back(P);
+                Preset = int(Run.Presets.size()) - 1;
+            }
+            Inputs.push_back({ In, Rel, Preset });
+        }
+    }
+    else
+    {
+        std::cout << "Can not open " << Source.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    //R1.01 Only add the preset name to the output when more than one preset is in use.
+    std::vector<bool> Used(Run.Presets.size(), false);
+    for (auto& i : Inputs)
+    {
+        if (0 <= i.Preset) Used[size_t(i.Preset)] = true;
+        else for (int p = 0; p < CmdPresets; p++) Used[size_t(p)] = true;
+    }
+    bool OnePreset = std::count(Used.begin(), Used.end(), true) <= 1;
+
+    //R1.01 The same input and preset can still be listed twice. Number the copies instead of overwriting.
+    juce::StringArray OutNames;
+    auto Add_Job = [&Run, &OutDir, &OnePreset, &OutNames](const t_BatchInput& i, int Preset)
+    {
+        t_BatchJob Job;
+        Job.In = i.In;
+        Job.Preset = Preset;
+        juce::String Stem = i.Rel.upToLastOccurrenceOf(".", false, false);
+        if (!OnePreset) Stem += "_" + Run.Presets[size_t(Preset)].Name;
+        juce::String Name = Stem;
+        for (int n = 2; OutNames.contains(Name, true); n++) Name = Stem + "_" + juce::String(n);
+        OutNames.add(Name);
+        Job.Out = OutDir.getChildFile(Name + ".wav");
+        Run.Jobs.push_back(Job);
+    };
+
+    for (auto& i : Inputs)
+    {
+        if (0 <= i.Preset) Add_Job(i, i.Preset);
+        else for (int p = 0; p < CmdPresets; p++) Add_Job(i, p);
+    }
+
+    if (Run.Jobs.empty())
+    {
+        std::cout << "No audio files found." << std::endl;
+        return 1;
+    }
+
+    //R1.01 Catch misspelled settings before any work starts.
+    {
+        MakoBiteAudioProcessor Check;
+        for (auto& P : Run.Presets)
+            for (auto& v : P.Values)
+                if (Check.parameters.getParameter(v.first) == nullptr)
+                {
+                    std::cout << "Preset " << P.Name << ": no parameter called " << v.first << std::endl;
+                    return 1;
+                }
+    }
+
+    Threads = juce::jmin(Threads, int(Run.Jobs.size()));
+    std::cout << Run.Jobs.size() << " jobs on " << Threads << " threads, " << Run.Chunk << " sample chunks." << std::endl;
+
+    double Start = juce::Time::getMillisecondCounterHiRes();
+    std::vector<std::unique_ptr<MakoBatchWorker>> Workers;
+    for (int t = 0; t < Threads; t++)
+    {
+        Workers.push_back(std::make_unique<MakoBatchWorker>(t, Run));
+        Workers.back()->startThread();
+    }
+    for (auto& w : Workers) w->waitForThreadToExit(-1);
+    double WallMs = juce::Time::getMillisecondCounterHiRes() - Start;
+
+    //R1.01 THROUGHPUT REPORT.
+    int Done = 0;
+    double AudioSec = 0.0;
+    double Frames = 0.0;
+    double Bytes = 0.0;
+    for (auto& Job : Run.Jobs)
+    {
+        if (!Job.Done) continue;
+        Done++;
+        AudioSec += double(Job.Samples) / Job.Rate;
+        Frames += double(Job.Samples) * Job.Channels;
+        Bytes += double(Job.Bytes);
+    }
+    double WallSec = WallMs * .001;
+
+    std::cout << std::endl << "Rendered " << Done << " of " << Run.Jobs.size() << " jobs in " << WallSec << " s." << std::endl;
+    if (0.0 < WallSec)
+    {
+        std::cout << "Audio " << AudioSec << " s, " << (AudioSec / WallSec) << "x real time, "
+                  << (Frames / WallSec * 1.0e-6) << " M samples/s, " << (Bytes / WallSec / 1048576.0) << " MB/s read." << std::endl;
+    }
+    for (int t = 0; t < int(Workers.size()); t++)
+    {
+        std::cout << "  worker " << t << ": " << Workers[size_t(t)]->Jobs << " jobs, busy "
+                  << (0.0 < WallMs ? 100.0 * Workers[size_t(t)]->BusyMs / WallMs : 0.0) << "%" << std::endl;
+    }
+    for (auto& Job : Run.Jobs)
+        if (!Job.Done) std::cout << "FAILED " << Job.In.getFullPathName() << ": " << Job.Error << std::endl;
+
+    return (Done == int(Run.Jobs.size())) ? 0 : 1;
+}
@@ -0,0 +1,228 @@
+/*
+  ==============================================================================
+
+    MakoEquivalence.cpp
+    Console tool. Renders the same guitar signal through the frozen scalar
+    reference (MakoReference.cpp) and through our optimized kernels, then reports
+    how far apart they are for every voice, parameter corner and sample rate.
+
+    Build as a JUCE console application with the same source files and
+    BinaryData as the plugin, and MAKO_REFERENCE_CHECK=1 defined for every file.
+
+    Usage: MakoEquivalence [-snr dB] [-dev max] [-pitch percent] [-cents c] [-block n]
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../PluginProcessor.h"
+
+#if ! MAKO_REFERENCE_CHECK
+ #error "MakoEquivalence needs MAKO_REFERENCE_CHECK=1 for the whole build."
+#endif
+
+//R1.01 One set of parameter values to test. Corners of the knob ranges plus the defaults.
+struct t_EqCorner {
+    const char* Name;
+    float Gain, Gliss, Mix, LP, Bal, Boost, PreGain, Attack, DTime, DLen, DMix;
+    int Mono;
+};
+
+static const t_EqCorner EQ_Corners[] = {
+    { "default",  1.0f, .24f, 1.0f, 200.0f, .5f, .0f, .2f, .0f, .4f, .2f, .1f, 1 },
+    { "low",      1.0f, .0f,  .5f,  50.0f,  .0f, .0f, .0f, .0f, .01f, .0f, .0f, 0 },
+    { "high",     1.0f, 1.0f, 1.0f, 500.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 0 },
+    { "hot",     10.0f, .5f,  .75f, 120.0f, .3f, .5f, .6f, .3f, .2f, .7f, .5f, 0 },
+};
+
+static const double EQ_Rates[] = { 44100.0, 48000.0, 88200.0, 96000.0, 192000.0 };
+static const int EQ_Voices = 10;          //R1.01 Voices 0 - 10. The sample voice needs a file and is not tested here.
+
+//R1.01 A plucked guitar line. Each note is a few decaying harmonics with a short gap after it, low E to high E.
+static void Eq_MakeGuitar(juce::AudioBuffer<float>& Buf, double Rate)
+{
+    const float Notes[] = { 82.41f, 110.0f, 146.83f, 196.0f, 246.94f, 329.63f, 440.0f, 659.26f, 164.81f, 98.0f };
+    const int NoteLen = int(Rate * .45);
+    const int GapLen = int(Rate * .05);
+    const int Cnt = int(sizeof(Notes) / sizeof(Notes[0]));
+
+    Buf.setSize(2, Cnt * (NoteLen + GapLen));
+    Buf.clear();
+
+    for (int n = 0; n < Cnt; n++)
+    {
+        int Start = n * (NoteLen + GapLen);
+        for (int t = 0; t < NoteLen; t++)
+        {
+            double Time = t / Rate;
+            double Env = exp(-Time * 4.0) * juce::jmin(1.0, t / (Rate * .002));
+            double v = 0.0;
+            for (int h = 1; h <= 6; h++) v += sin(2.0 * juce::MathConstants<double>::pi * Notes[n] * h * Time + h) * exp(-Time * h * 1.5) / h;
+            float s = float(.6 * Env * v);
+            Buf.setSample(0, Start + t, s);
+            Buf.setSample(1, Start + t, s * .8f);
+        }
+    }
+}
+
+static void Eq_SetParm(MakoBiteAudioProcessor& Proc, const char* ID, float Value)
+{
+    if (auto* p = Proc.parameters.getParameter(ID)) p->setValueNotifyingHost(p->convertTo0to1(Value));
+}
+
+static void Eq_Setup(MakoBiteAudioProcessor& Proc, const t_EqCorner& C, int Voice, double Rate, int Block, bool Reference)
+{
+    Eq_SetParm(Proc, "gain", C.Gain);
+    Eq_SetParm(Proc, "voice", float(Voice));
+    Eq_SetParm(Proc, "gliss", C.Gliss);
+    Eq_SetParm(Proc, "mix", C.Mix);
+    Eq_SetParm(Proc, "lp", C.LP);
+    Eq_SetParm(Proc, "bal", C.Bal);
+    Eq_SetParm(Proc, "boost", C.Boost);
+    Eq_SetParm(Proc, "pregain", C.PreGain);
+    Eq_SetParm(Proc, "attack", C.Attack);
+    Eq_SetParm(Proc, "dtime", C.DTime);
+    Eq_SetParm(Proc, "dlen", C.DLen);
+    Eq_SetParm(Proc, "dmix", C.DMix);
+    Eq_SetParm(Proc, "mono", float(C.Mono));
+    Eq_SetParm(Proc, "midi", 1.0f);    //R1.01 Keeps the tracker running even when the synth is off.
+
+    Proc.Reference_Set(Reference);
+    Proc.setPlayConfigDetails(2, 2, Rate, Block);
+    Proc.prepareToPlay(Rate, Block);
+}
+
+struct t_EqResult {
+    double SNR;          //R1.01 dB. 999 = identical.
+    double MaxDev;
+    double PitchAgree;   //R1.01 Percent of tracked blocks where both trackers agree.
+    double RefMs;
+    double OptMs;
+};
+
+static t_EqResult Eq_Run(const t_EqCorner& C, int Voice, double Rate, int Block, double Cents)
+{
+    juce::AudioBuffer<float> Input;
+    Eq_MakeGuitar(Input, Rate);
+    int Total = Input.getNumSamples();
+
+    auto Ref = std::make_unique<MakoBiteAudioProcessor>();
+    auto Opt = std::make_unique<MakoBiteAudioProcessor>();
+    Eq_Setup(*Ref, C, Voice, Rate, Block, true);
+    Eq_Setup(*Opt, C, Voice, Rate, Block, false);
+
+    juce::AudioBuffer<float> BufRef(2, Block), BufOpt(2, Block);
+    juce::MidiBuffer Midi;
+    double Sig = 0.0, Err = 0.0, MaxDev = 0.0;
+    int Tracked = 0, Agree = 0;
+    t_EqResult R = {};
+
+    for (int Start = 0; Start < Total; Start += Block)
+    {
+        int num = juce::jmin(Block, Total - Start);
+        BufRef.setSize(2, num, false, false, true);
+        BufOpt.setSize(2, num, false, false, true);
+        for (int ch = 0; ch < 2; ch++)
+        {
+            BufRef.copyFrom(ch, 0, Input, ch, Start, num);
+            BufOpt.copyFrom(ch, 0, Input, ch, Start, num);
+        }
+
+        double t0 = juce::Time::getMillisecondCounterHiRes();
+        Midi.clear();
+        Ref->processBlock(BufRef, Midi);
+        double t1 = juce::Time::getMillisecondCounterHiRes();
+        Midi.clear();
+        Opt->processBlock(BufOpt, Midi);
+        double t2 = juce::Time::getMillisecondCounterHiRes();
+        R.RefMs += t1 - t0;
+        R.OptMs += t2 - t1;
+
+        for (int ch = 0; ch < 2; ch++)
+        {
+            const float* a = BufRef.getReadPointer(ch);
+            const float* b = BufOpt.getReadPointer(ch);
+            for (int t = 0; t < num; t++)
+            {
+                double d = double(b[t]) - double(a[t]);
+                Sig += double(a[t]) * a[t];
+                Err += d * d;
+                MaxDev = juce::jmax(MaxDev, std::abs(d));
+            }
+        }
+
+        //R1.01 Pitch agreement, checked once per block on channel 0.
+        float fRef = Ref->Track_Freq(0);
+        float fOpt = Opt->Track_Freq(0);
+        if (0.0f < fRef)
+        {
+            Tracked++;
+            if ((0.0f < fOpt) && (std::abs(1200.0 * log2(double(fOpt) / fRef)) <= Cents)) Agree++;
+        }
+    }
+
+    Ref->releaseResources();
+    Opt->releaseResources();
+
+    R.SNR = (Err <= 0.0) ? 999.0 : (Sig <= 0.0) ? -999.0 : 10.0 * log10(Sig / Err);
+    R.MaxDev = MaxDev;
+    R.PitchAgree = Tracked ? 100.0 * Agree / Tracked : 100.0;
+    return R;
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI JuceInit;
+
+    //R1.01 Pass limits. Optimized kernels may move results by rounding, not by audible amounts.
+    double MinSNR = 80.0;
+    double MaxDev = 1.0e-3;
+    double MinPitch = 99.0;
+    double Cents = 25.0;
+    int Block = 512;
+
+    for (int a = 1; a + 1 < argc; a += 2)
+    {
+        juce::String Arg(argv[a]);
+        double v = juce::String(argv[a + 1]).getDoubleValue();
+        if (Arg == "-snr") MinSNR = v;
+        else if (Arg == "-dev") MaxDev = v;
+        else if (Arg == "-pitch") MinPitch = v;
+        else if (Arg == "-cents") Cents = v;
+        else if (Arg == "-block") Block = juce::jmax(1, int(v));
+        else
+        {
+            std::cout << "Usage: MakoEquivalence [-snr dB] [-dev max] [-pitch percent] [-cents c] [-block n]" << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "Limits: SNR >= " << MinSNR << " dB, max deviation <= " << MaxDev << ", pitch agreement >= "
+              << MinPitch << "% within " << Cents << " cents. Block " << Block << "." << std::endl;
+
+    int Cases = 0, Failed = 0;
+    double RefMs = 0.0, OptMs = 0.0;
+
+    for (double Rate : EQ_Rates)
+        for (const t_EqCorner& C : EQ_Corners)
+            for (int Voice = 0; Voice <= EQ_Voices; Voice++)
+            {
+                t_EqResult R = Eq_Run(C, Voice, Rate, Block, Cents);
+                bool Pass = (MinSNR <= R.SNR) && (R.MaxDev <= MaxDev) && (MinPitch <= R.PitchAgree);
+
+                std::cout << (Pass ? "PASS " : "FAIL ") << int(Rate) << " Hz  voice " << Voice << "  " << C.Name
+                          << "  SNR " << R.SNR << " dB  max dev " << R.MaxDev << "  pitch " << R.PitchAgree << "%" << std::endl;
+
+                Cases++;
+                if (!Pass) Failed++;
+                RefMs += R.RefMs;
+                OptMs += R.OptMs;
+            }
+
+    std::cout << Cases - Failed << " of " << Cases << " cases passed." << std::endl;
+    std::cout << "Reference " << RefMs << " ms, optimized " << OptMs << " ms";
+    if (0.0 < OptMs) std::cout << " (" << (RefMs / OptMs) << "x)";
+    std::cout << std::endl;
+
+    return Failed ? 1 : 0;
+}
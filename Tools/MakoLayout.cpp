@@ -0,0 +1,144 @@
+/*
+  ==============================================================================
+
+    MakoLayout.cpp
+    Console tool. Checks the memory layout of the processor's hot state:
+    the size and cache lines of tp_chanstate, that every channel starts on
+    its own line for any channel count, and that nothing another thread
+    writes or reads often shares a cache line with what the audio thread
+    writes every block (false sharing).
+
+    Build as a JUCE console application with the same source files and
+    BinaryData as the plugin.
+
+    Usage: MakoLayout [-channels n]
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../PluginProcessor.h"
+
+static const int LAYOUT_Line = 64;
+
+//R1.01 One member of the processor and the cache lines it covers.
+struct t_LayoutItem
+{
+    const char* Name;
+    std::uintptr_t Start;
+    std::size_t Size;
+
+    std::uintptr_t FirstLine() const { return Start / LAYOUT_Line; }
+    std::uintptr_t LastLine() const { return (Start + Size - 1) / LAYOUT_Line; }
+    bool SharesLine(const t_LayoutItem& o) const { return (FirstLine() <= o.LastLine()) && (o.FirstLine() <= LastLine()); }
+};
+
+#define LAYOUT_ITEM(obj, m) t_LayoutItem { #m, std::uintptr_t(&(obj).m), sizeof((obj).m) }
+#define LAYOUT_OFFSET(m) std::cout << "  " << #m << ": " << offsetof(MakoBiteAudioProcessor::tp_chanstate, m) << std::endl
+
+//R1.01 A friend of the processor, so it can see the private members.
+struct MakoLayout
+{
+    static int Chan_Report()
+    {
+        typedef MakoBiteAudioProcessor::tp_chanstate t_CS;
+        int Lines = int((sizeof(t_CS) + LAYOUT_Line - 1) / LAYOUT_Line);
+        std::cout << "tp_chanstate: " << sizeof(t_CS) << " bytes, align " << alignof(t_CS) << ", " << Lines
+                  << " cache lines (limit " << MakoBiteAudioProcessor::CHAN_Lines << ")" << std::endl;
+        LAYOUT_OFFSET(Mod_Phase);
+        LAYOUT_OFFSET(Mod_Peak);
+        LAYOUT_OFFSET(Signal_AVG);
+        LAYOUT_OFFSET(Delay_B_Idx);
+        LAYOUT_OFFSET(Filt);
+        LAYOUT_OFFSET(Sample_Pos);
+        LAYOUT_OFFSET(Sample_Zone);
+        return (MakoBiteAudioProcessor::CHAN_Lines < Lines) ? 1 : 0;
+    }
+
+    //R1.01 Every channel on its own lines, and the block on lines of its own.
+    static int Chan_Check(MakoBiteAudioProcessor& P)
+    {
+        int Bad = 0;
+        for (int t = 0; t < P.Chan_Cnt; t++)
+        {
+            std::uintptr_t a = std::uintptr_t(&P.Chan_State[t]);
+            if ((a % LAYOUT_Line) != 0)
+            {
+                std::cout << "FAILED: channel " << t << " does not start on a cache line." << std::endl;
+                Bad++;
+            }
+        }
+        return Bad;
+    }
+
+    //R1.01 FALSE SHARING.
+    //R1.01 Hot = written by the audio thread every block. Shared = written by another thread, or
+    //R1.01 read by one often. No hot member may be on a line with a shared one.
+    static int Share_Check(MakoBiteAudioProcessor& P)
+    {
+        const t_LayoutItem Hot[] = {
+            LAYOUT_ITEM(P, Parm_Events), LAYOUT_ITEM(P, Parm_EventCnt), LAYOUT_ITEM(P, Settings_Force), LAYOUT_ITEM(P, Segment_Clock),
+            LAYOUT_ITEM(P, Bypass_FadeCnt), LAYOUT_ITEM(P, Midi_Out), LAYOUT_ITEM(P, Midi_Offset),
+            LAYOUT_ITEM(P, Midi_Base), LAYOUT_ITEM(P, Midi_Last), LAYOUT_ITEM(P, Gov_Ticks),
+            LAYOUT_ITEM(P, Gov_Samples), LAYOUT_ITEM(P, Analysis_LPRun),
+            t_LayoutItem { "Chan_State", std::uintptr_t(P.Chan_State.data()), P.Chan_State.size() * sizeof(P.Chan_State[0]) },
+        };
+        const t_LayoutItem Shared[] = {
+            LAYOUT_ITEM(P, SettingsChanged), LAYOUT_ITEM(P, Settings_ForceReq), LAYOUT_ITEM(P, Setting), LAYOUT_ITEM(P, Gov_Level),
+            LAYOUT_ITEM(P, Gov_Load), LAYOUT_ITEM(P, SampleLoader),
+        };
+
+        int Bad = 0;
+        for (const t_LayoutItem& h : Hot)
+            for (const t_LayoutItem& s : Shared)
+                if (h.SharesLine(s))
+                {
+                    std::cout << "FAILED: " << h.Name << " shares a cache line with " << s.Name << std::endl;
+                    Bad++;
+                }
+        return Bad;
+    }
+};
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI JuceInit;
+
+    int MaxChans = 8;
+    for (int a = 1; a + 1 < argc; a += 2)
+    {
+        juce::String Arg(argv[a]);
+        if (Arg == "-channels") MaxChans = juce::jmax(1, juce::String(argv[a + 1]).getIntValue());
+        else
+        {
+            std::cout << "Usage: MakoLayout [-channels n]" << std::endl;
+            return 1;
+        }
+    }
+    if ((argc % 2) == 0)
+    {
+        std::cout << "Usage: MakoLayout [-channels n]" << std::endl;
+        return 1;
+    }
+
+    int Bad = MakoLayout::Chan_Report();
+
+    auto Proc = std::make_unique<MakoBiteAudioProcessor>();
+    if ((std::uintptr_t(Proc.get()) % alignof(MakoBiteAudioProcessor)) != 0)
+    {
+        std::cout << "FAILED: the processor is not allocated on its own alignment." << std::endl;
+        Bad++;
+    }
+
+    for (int Chans = 1; Chans <= MaxChans; Chans++)
+    {
+        Proc->setPlayConfigDetails(Chans, Chans, 48000.0, 512);
+        Proc->prepareToPlay(48000.0, 512);
+        Bad += MakoLayout::Chan_Check(*Proc);
+        Bad += MakoLayout::Share_Check(*Proc);
+        Proc->releaseResources();
+    }
+
+    if (Bad == 0) std::cout << "Layout OK for 1 - " << MaxChans << " channels. No false sharing." << std::endl;
+    return (Bad == 0) ? 0 : 1;
+}
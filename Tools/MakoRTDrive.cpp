@@ -0,0 +1,166 @@
+/*
+  ==============================================================================
+
+    MakoRTDrive.cpp
+    Console tool. Drives the processor through every parameter and block
+    size scenario with the real time safety check on. Any allocation, free
+    or lock on the audio thread stops the run with a stack trace, so a run
+    that reaches the end is a pass.
+
+    Build as a JUCE console application with the same source files and
+    BinaryData as the plugin, plus MAKO_RTCHECK=1. On Linux link with -ldl
+    if your glibc is older than 2.34.
+
+    Usage: MakoRTDrive [-seconds s] [-seed n]
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../PluginProcessor.h"
+#include "../MakoRTCheck.h"
+
+static const double DRIVE_Rates[] = { 44100.0, 48000.0, 96000.0, 192000.0 };
+static const int DRIVE_Promised[] = { 32, 256, 1024 };
+static const int DRIVE_Blocks[] = { 1, 7, 33, 511 };                //R1.01 Sizes hosts really send.
+static const int DRIVE_MidiBytes = 16384;                          //R1.01 Host side MIDI buffer. Hosts reserve theirs too.
+
+//R1.01 Plucks with silence between them, so the tracker, MIDI out and the sample voice all run.
+static void Drive_Input(juce::AudioBuffer<float>& Buf, int num, juce::int64 Pos, double Rate)
+{
+    for (int ch = 0; ch < Buf.getNumChannels(); ch++)
+    {
+        float* d = Buf.getWritePointer(ch);
+        for (int t = 0; t < num; t++)
+        {
+            double Time = double(Pos + t) / Rate;
+            double Note = fmod(Time, .4);
+            d[t] = (Note < .3) ? float(.5 * exp(-Note * 5.0) * sin(2.0 * juce::MathConstants<double>::pi * 82.4 * (1 + int(Time / .4) % 5) * Time)) : 0.0f;
+        }
+    }
+}
+
+//R1.01 The host side of one block. Only processBlock runs under the check.
+struct t_DriveHost
+{
+    MakoBiteAudioProcessor* Proc = nullptr;
+    juce::AudioBuffer<float> Buf;
+    juce::MidiBuffer Midi;
+    double Rate = 48000.0;
+    int Chans = 2;
+    juce::int64 Pos = 0;
+    juce::int64 Blocks = 0;
+
+    void Block(int num, bool Bypassed)
+    {
+        Buf.setSize(Chans, num, false, false, true);
+        Drive_Input(Buf, num, Pos, Rate);
+        Midi.clear();
+        if (Bypassed)
+            Proc->processBlockBypassed(Buf, Midi);
+        else
+            Proc->processBlock(Buf, Midi);
+        Pos += num;
+        Blocks++;
+    }
+
+    void Run(double Seconds, int num, bool Bypassed)
+    {
+        juce::int64 Len = juce::jmax(juce::int64(1), juce::int64(Seconds * Rate));
+        for (juce::int64 t = 0; t < Len; t += num) Block(num, Bypassed);
+    }
+};
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI JuceInit;
+
+    double Seconds = .25;
+    juce::int64 Seed = 1;
+
+    for (int a = 1; a + 1 < argc; a += 2)
+    {
+        juce::String Arg(argv[a]);
+        juce::String Val(argv[a + 1]);
+        if (Arg == "-seconds") Seconds = juce::jmax(.01, Val.getDoubleValue());
+        else if (Arg == "-seed") Seed = Val.getLargeIntValue();
+        else
+        {
+            std::cout << "Usage: MakoRTDrive [-seconds s] [-seed n]" << std::endl;
+            return 1;
+        }
+    }
+    if ((argc % 2) == 0)
+    {
+        std::cout << "Usage: MakoRTDrive [-seconds s] [-seed n]" << std::endl;
+        return 1;
+    }
+
+   #if ! MAKO_RTCHECK
+    std::cout << "Built without MAKO_RTCHECK. Nothing would be checked." << std::endl;
+    return 1;
+   #endif
+
+    juce::Random Rnd(Seed);
+    auto Proc = std::make_unique<MakoBiteAudioProcessor>();
+    auto& Parms = Proc->getParameters();
+    t_DriveHost Host;
+    Host.Proc = Proc.get();
+    Host.Midi.ensureSize(size_t(DRIVE_MidiBytes));
+    int Scenarios = 0;
+
+    for (double Rate : DRIVE_Rates)
+        for (int Promised : DRIVE_Promised)
+            for (int Chans = 1; Chans <= 2; Chans++)
+            {
+                Host.Rate = Rate;
+                Host.Chans = Chans;
+                Host.Pos = 0;
+                Proc->setPlayConfigDetails(Chans, Chans, Rate, Promised);
+                Proc->prepareToPlay(Rate, Promised);
+                for (int ch = 0; ch < Chans; ch++) Proc->Delay_SetChannelRatio(ch, .01f + Rnd.nextFloat());
+                std::cout << Rate << " Hz, " << Chans << " ch, block " << Promised << std::endl;
+
+                //R1.01 BLOCK SIZES. The awkward ones, the promised one, and more than was promised.
+                for (int num : DRIVE_Blocks) Host.Run(Seconds, num, false);
+                Host.Run(Seconds, Promised, false);
+                Host.Run(Seconds, Promised * 4, false);
+                Scenarios += 6;
+
+                //R1.01 PARAMETERS. Each one to both ends and back, with a block at each step. Every switch,
+                //R1.01 voice and mode gets turned on this way.
+                for (auto* p : Parms)
+                {
+                    float Was = p->getValue();
+                    for (float v : { 0.0f, 1.0f, Rnd.nextFloat(), Was })
+                    {
+                        p->setValueNotifyingHost(v);
+                        Proc->SettingsChanged += 1;
+                        Host.Block(DRIVE_Blocks[Rnd.nextInt(4)], false);
+                        Host.Block(Promised, false);
+                    }
+                    Scenarios++;
+                }
+
+                //R1.01 STORMS. Many parameters at once, every block, at random sizes.
+                for (int b = 0; b < 200; b++)
+                {
+                    for (int t = Rnd.nextInt(20); 0 <= t; t--) Parms[Rnd.nextInt(int(Parms.size()))]->setValueNotifyingHost(Rnd.nextFloat());
+                    Proc->SettingsChanged += 1;
+                    Host.Block(1 + Rnd.nextInt(Promised * 2), false);
+                }
+                Scenarios++;
+
+                //R1.01 BYPASS. In and out, mid fade too.
+                for (int b = 0; b < 50; b++) Host.Block(DRIVE_Blocks[Rnd.nextInt(4)], (b & 1) == 0);
+                Host.Run(Seconds, Promised, true);
+                Host.Run(Seconds, Promised, false);
+                Scenarios++;
+
+                Proc->releaseResources();
+            }
+
+    //R1.01 A violation aborts, so getting here is a pass.
+    std::cout << std::endl << Scenarios << " scenarios, " << Host.Blocks << " blocks. No allocation, free or lock on the audio thread." << std::endl;
+    return 0;
+}
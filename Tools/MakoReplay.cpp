@@ -0,0 +1,147 @@
+/*
+  ==============================================================================
+
+    MakoReplay.cpp
+    Console tool. Plays a capture file (MakoRecorder) back through the
+    processor, block for block, and writes what came out to a WAVE file.
+
+    Build as a JUCE console application with the same source files and
+    BinaryData as the plugin. The editor is linked in but never opened.
+
+    Usage: MakoReplay capture.mkr [out.wav]
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../PluginProcessor.h"
+
+//R1.01 Read one fixed size piece of a record. False at the end of the file.
+static bool Replay_Read(juce::InputStream& In, void* Dest, int Bytes)
+{
+    return In.read(Dest, Bytes) == Bytes;
+}
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI JuceInit;
+
+    if (argc < 2)
+    {
+        std::cout << "Usage: MakoReplay capture.mkr [out.wav]" << std::endl;
+        return 1;
+    }
+
+    juce::File CaptureFile = juce::File::getCurrentWorkingDirectory().getChildFile(argv[1]);
+    juce::FileInputStream In(CaptureFile);
+    if (!In.openedOk())
+    {
+        std::cout << "Can not open " << CaptureFile.getFullPathName() << std::endl;
+        return 1;
+    }
+
+    //R1.01 HEADER. Sets up the processor exactly as it was when the capture started.
+    t_RecHeader Hdr;
+    if (!Replay_Read(In, &Hdr, sizeof(Hdr)) || (Hdr.Type != MakoRecorder::e_Rec_Header) || (Hdr.Magic != MakoRecorder::REC_Magic))
+    {
+        std::cout << "Not a MonoTone capture file." << std::endl;
+        return 1;
+    }
+    if (Hdr.Version != MakoRecorder::REC_Version)
+    {
+        std::cout << "Capture version " << Hdr.Version << " is not supported." << std::endl;
+        return 1;
+    }
+
+    std::vector<float> Settings(size_t(Hdr.ParmCnt));
+    std::vector<float> Ratios(size_t(Hdr.ChanCnt));
+    Replay_Read(In, Settings.data(), int(sizeof(float)) * Hdr.ParmCnt);
+    Replay_Read(In, Ratios.data(), int(sizeof(float)) * Hdr.ChanCnt);
+
+    auto Proc = std::make_unique<MakoBiteAudioProcessor>();
+    Proc->setPlayConfigDetails(Hdr.NumIn, Hdr.NumOut, Hdr.SampleRate, Hdr.MaxBlock);
+    Proc->Replay_Prepare(Hdr, Settings.data(), Ratios.data());
+    Proc->prepareToPlay(Hdr.SampleRate, Hdr.MaxBlock);
+
+    //R1.01 Optional output file. 32 bit float so the result can be compared bit for bit.
+    std::unique_ptr<juce::AudioFormatWriter> Writer;
+    if (2 < argc)
+    {
+        juce::File OutFile = juce::File::getCurrentWorkingDirectory().getChildFile(argv[2]);
+        OutFile.deleteFile();
+        juce::WavAudioFormat Wav;
+        Writer.reset(Wav.createWriterFor(new juce::FileOutputStream(OutFile), Hdr.SampleRate, juce::uint32(Hdr.NumOut), 32, {}, 0));
+        if (Writer == nullptr)
+        {
+            std::cout << "Can not write " << OutFile.getFullPathName() << std::endl;
+            return 1;
+        }
+    }
+
+    juce::AudioBuffer<float> Buffer;
+    juce::MidiBuffer Midi;
+    std::vector<t_RecEvent> Events;
+    juce::int64 Blocks = 0;
+    juce::int64 Samples = 0;
+    double ProcessTime = 0.0;
+    int Lost = 0;
+
+    //R1.01 BLOCKS. Each one is fed to the processor the same way the host did.
+    for (;;)
+    {
+        juce::int32 Type;
+        if (!Replay_Read(In, &Type, sizeof(Type))) break;
+
+        if (Type == MakoRecorder::e_Rec_End)
+        {
+            juce::int32 EndLost = 0;
+            Replay_Read(In, &EndLost, sizeof(EndLost));
+            Lost = EndLost;
+            break;
+        }
+
+        if ((Type != MakoRecorder::e_Rec_Block) && (Type != MakoRecorder::e_Rec_Bypassed))
+        {
+            std::cout << "Bad record in capture after block " << Blocks << std::endl;
+            return 1;
+        }
+
+        t_RecBlock Blk;
+        Blk.Type = Type;
+        if (!Replay_Read(In, reinterpret_cast<char*>(&Blk) + sizeof(Type), int(sizeof(Blk) - sizeof(Type)))) break;
+
+        Events.resize(size_t(Blk.EventCnt));
+        Replay_Read(In, Settings.data(), int(sizeof(float)) * Hdr.ParmCnt);
+        Replay_Read(In, Events.data(), int(sizeof(t_RecEvent)) * Blk.EventCnt);
+
+        Buffer.setSize(Blk.NumChannels, Blk.NumSamples, false, false, true);
+        for (int t = 0; t < Blk.NumChannels; t++)
+            Replay_Read(In, Buffer.getWritePointer(t), int(sizeof(float)) * Blk.NumSamples);
+
+        Midi.clear();
+        Proc->Replay_Block(Blk, Settings.data(), Events.data());
+
+        double Start = juce::Time::getMillisecondCounterHiRes();
+        if (Type == MakoRecorder::e_Rec_Bypassed)
+            Proc->processBlockBypassed(Buffer, Midi);
+        else
+            Proc->processBlock(Buffer, Midi);
+        ProcessTime += juce::Time::getMillisecondCounterHiRes() - Start;
+
+        if (Writer != nullptr) Writer->writeFromAudioSampleBuffer(Buffer, 0, Blk.NumSamples);
+
+        Blocks++;
+        Samples += Blk.NumSamples;
+    }
+
+    Proc->releaseResources();
+
+    double Seconds = double(Samples) / Hdr.SampleRate;
+    std::cout << "Replayed " << Blocks << " blocks, " << Samples << " samples (" << Seconds << " s) at " << Hdr.SampleRate << " Hz." << std::endl;
+    std::cout << "processBlock time " << ProcessTime << " ms";
+    if (0.0 < Seconds) std::cout << " (" << (ProcessTime * .1 / Seconds) << "% of real time)";
+    std::cout << std::endl;
+    if (Lost) std::cout << "WARNING: the capture overflowed while recording. It stops early." << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,311 @@
+/*
+  ==============================================================================
+
+    MakoStress.cpp
+    Console tool. Runs the processor the way a badly behaved host would:
+    odd block sizes, sample rate and channel changes mid session, bypass
+    flips and storms of parameter changes. Reports timing jitter, the worst
+    block cost per sample, bad output and (with MAKO_BOUNDS_CHECK=1) every
+    out of range buffer access. CLAP builds (MAKO_CLAP=1) also check that a
+    direct parameter event is still in effect after the next block.
+
+    Build as a JUCE console application with the same source files and
+    BinaryData as the plugin. Add MAKO_BOUNDS_CHECK=1 for the range checks.
+
+    Sanitizer build (GCC or Clang, Linux or Mac). Add to both the compiler and
+    the linker flags of a Debug configuration, in the Projucer exporter:
+      -fsanitize=address,undefined -fno-omit-frame-pointer -fno-sanitize-recover=undefined
+    and add _GLIBCXX_ASSERTIONS=1 and MAKO_BOUNDS_CHECK=1 to the preprocessor
+    definitions. Any heap overrun, use after free, undefined behaviour or bad
+    std::vector index then stops the run with a report. Leave MAKO_RTCHECK
+    off in this build: it replaces malloc, and so does the address sanitizer.
+
+    Usage: MakoStress [-sessions n] [-seconds s] [-seed n] [-storm percent]
+
+  ==============================================================================
+*/
+
+#include <JuceHeader.h>
+#include "../PluginProcessor.h"
+#include "../MakoBounds.h"
+#include "../MakoKernels.h"
+
+//R1.01 Which sanitizers this build has, so a report says what was checked.
+#if defined (__SANITIZE_ADDRESS__)
+ #define STRESS_ASAN 1
+#elif defined (__has_feature)
+ #if __has_feature (address_sanitizer)
+  #define STRESS_ASAN 1
+ #endif
+#endif
+#ifndef STRESS_ASAN
+ #define STRESS_ASAN 0
+#endif
+
+static const double STRESS_Rates[] = { 22050.0, 44100.0, 48000.0, 88200.0, 96000.0, 176400.0, 192000.0 };
+static const int STRESS_Blocks[] = { 1, 7, 33, 511 };              //R1.01 Sizes hosts really send.
+static const int STRESS_Classes = 4;                               //R1.01 Block size classes for the timing report.
+static const char* STRESS_ClassNames[STRESS_Classes] = { "1-8", "9-64", "65-512", "513+" };
+
+static int Stress_Class(int num)
+{
+    return (num <= 8) ? 0 : (num <= 64) ? 1 : (num <= 512) ? 2 : 3;
+}
+
+//R1.01 Block cost per sample, in nanoseconds, for one size class.
+struct t_StressTiming {
+    std::vector<double> NsPerSample;
+    double WorstBudget = 0.0;         //R1.01 Largest block time / block real time.
+    int WorstSize = 0;
+    double WorstRate = 0.0;
+};
+
+static double Stress_Percentile(std::vector<double>& v, double p)
+{
+    if (v.empty()) return 0.0;
+    size_t i = size_t(p * double(v.size() - 1));
+    std::nth_element(v.begin(), v.begin() + i, v.end());
+    return v[i];
+}
+
+//R1.01 Guitar-ish test input. Plucks with silence between them, plus the odd loud or DC block.
+static void Stress_Input(juce::AudioBuffer<float>& Buf, int num, juce::int64 Pos, double Rate, juce::Random& Rnd)
+{
+    int Mode = Rnd.nextInt(40);
+    for (int ch = 0; ch < Buf.getNumChannels(); ch++)
+    {
+        float* d = Buf.getWritePointer(ch);
+        for (int t = 0; t < num; t++)
+        {
+            double Time = double(Pos + t) / Rate;
+            double Note = fmod(Time, .6);
+            double v = (Note < .45) ? .5 * exp(-Note * 5.0) * sin(2.0 * juce::MathConstants<double>::pi * 110.0 * (1 + int(Time / .6) % 4) * Time) : 0.0;
+            if (Mode == 0) v = 1.0;                                     //R1.01 Full scale DC.
+            else if (Mode == 1) v = (Rnd.nextFloat() * 2.0f - 1.0f);    //R1.01 Full scale noise.
+            else if (Mode == 2) v = 0.0;                                //R1.01 Digital silence.
+            d[t] = float(v);
+        }
+    }
+}
+
+//R1.01 Move Cnt random parameters to random values.
+static void Stress_Storm(MakoBiteAudioProcessor& Proc, juce::Random& Rnd, int Cnt)
+{
+    auto& Parms = Proc.getParameters();
+    if (Parms.size() == 0) return;
+    for (int t = 0; t < Cnt; t++)
+    {
+        auto* p = Parms[Rnd.nextInt(int(Parms.size()))];
+        p->setValueNotifyingHost(Rnd.nextFloat());
+    }
+    Proc.SettingsChanged += 1;
+}
+
+#if MAKO_CLAP
+//R1.01 A CLAP value sent mid block must still be there after the following block. The host poll must not
+//R1.01 put the old APVTS value back. Order matches the processor's e_ Settings enum.
+static int Stress_Direct(MakoBiteAudioProcessor& Proc)
+{
+    static const char* DirectIDs[] = { "gain", "voice", "gliss", "mix", "lp", "bal", "boost", "pregain", "attack", "dtime", "dlen", "dmix" };
+    Proc.setPlayConfigDetails(2, 2, 48000.0, 512);
+    Proc.prepareToPlay(48000.0, 512);
+    juce::AudioBuffer<float> Buf(2, 512);
+    juce::MidiBuffer Midi;
+
+    int Bad = 0;
+    for (int t = 0; t < int(sizeof(DirectIDs) / sizeof(DirectIDs[0])); t++)
+    {
+        juce::RangedAudioParameter* p = Proc.parameters.getParameter(DirectIDs[t]);
+        if (p == nullptr) continue;
+
+        //R1.01 Move it to the other end of its range, part way into the block.
+        float Norm = (p->getValue() < .5f) ? 1.0f : 0.0f;
+        float Want = p->convertFrom0to1(Norm);
+        clap_event_param_value_t Ev = {};
+        Ev.header.size = sizeof(Ev);
+        Ev.header.space_id = CLAP_CORE_EVENT_SPACE_ID;
+        Ev.header.type = CLAP_EVENT_PARAM_VALUE;
+        Ev.cookie = static_cast<juce::AudioProcessorParameter*>(p);
+        Ev.value = Norm;
+
+        Buf.clear();
+        Proc.handleDirectEvent(&Ev.header, 100);
+        Proc.processBlock(Buf, Midi);
+        Proc.processBlock(Buf, Midi);
+        if (Proc.Setting[t] != Want)
+        {
+            std::cout << "FAILED: CLAP event for " << DirectIDs[t] << " set " << Want << ", one block later it is " << Proc.Setting[t] << std::endl;
+            Bad++;
+        }
+    }
+    Proc.releaseResources();
+    return Bad;
+}
+#endif
+
+int main(int argc, char* argv[])
+{
+    juce::ScopedJuceInitialiser_GUI JuceInit;
+
+    int Sessions = 40;
+    double Seconds = 4.0;
+    juce::int64 Seed = 1;
+    int StormPct = 10;
+
+    for (int a = 1; a + 1 < argc; a += 2)
+    {
+        juce::String Arg(argv[a]);
+        juce::String Val(argv[a + 1]);
+        if (Arg == "-sessions") Sessions = juce::jmax(1, Val.getIntValue());
+        else if (Arg == "-seconds") Seconds = juce::jmax(.01, Val.getDoubleValue());
+        else if (Arg == "-seed") Seed = Val.getLargeIntValue();
+        else if (Arg == "-storm") StormPct = juce::jlimit(0, 100, Val.getIntValue());
+        else
+        {
+            std::cout << "Usage: MakoStress [-sessions n] [-seconds s] [-seed n] [-storm percent]" << std::endl;
+            return 1;
+        }
+    }
+    if ((argc % 2) == 0)
+    {
+        std::cout << "Usage: MakoStress [-sessions n] [-seconds s] [-seed n] [-storm percent]" << std::endl;
+        return 1;
+    }
+
+    std::cout << "DSP kernels: " << MakoKernels_Name() << std::endl;
+    std::cout << "Address sanitizer: " << (STRESS_ASAN ? "on" : "off")
+             #if defined (_GLIBCXX_ASSERTIONS)
+              << ", library assertions: on"
+             #endif
+              << std::endl;
+
+   #if MAKO_BOUNDS_CHECK
+    MakoBounds::Clear();
+   #else
+    std::cout << "Built without MAKO_BOUNDS_CHECK. Out of range buffer access is not being checked." << std::endl;
+   #endif
+
+    juce::Random Rnd(Seed);
+    auto Proc = std::make_unique<MakoBiteAudioProcessor>();
+    juce::AudioBuffer<float> Buf;
+    juce::MidiBuffer Midi;
+    t_StressTiming Timing[STRESS_Classes];
+    const double TickNs = 1.0e9 / double(juce::Time::getHighResolutionTicksPerSecond());
+
+    juce::int64 Blocks = 0;
+    juce::int64 Samples = 0;
+    juce::int64 BadSamples = 0;
+    int Storms = 0;
+    int Bypasses = 0;
+
+    for (int s = 0; s < Sessions; s++)
+    {
+        //R1.01 New session. Rate, channel count and promised block size can all change, like a host
+        //R1.01 reconfiguring without releasing first. The host then breaks its promise on purpose.
+        double Rate = STRESS_Rates[Rnd.nextInt(int(sizeof(STRESS_Rates) / sizeof(STRESS_Rates[0])))];
+        int Chans = 1 + Rnd.nextInt(2);
+        int Promised = 16 << Rnd.nextInt(8);
+        Proc->setPlayConfigDetails(Chans, Chans, Rate, Promised);
+        Proc->prepareToPlay(Rate, Promised);
+        for (int ch = 0; ch < Chans; ch++) Proc->Delay_SetChannelRatio(ch, .01f + Rnd.nextFloat());
+
+        std::cout << "Session " << s + 1 << ": " << Rate << " Hz, " << Chans << " ch, block " << Promised << std::endl;
+
+        juce::int64 Len = juce::int64(Seconds * Rate);
+        bool Bypassed = false;
+        for (juce::int64 Pos = 0; Pos < Len; )
+        {
+            //R1.01 Mostly the awkward sizes, sometimes anything up to 4x the promised size.
+            int num = (Rnd.nextInt(3) != 0) ? STRESS_Blocks[Rnd.nextInt(4)] : 1 + Rnd.nextInt(Promised * 4);
+            Buf.setSize(Chans, num, false, false, true);
+            Stress_Input(Buf, num, Pos, Rate, Rnd);
+
+            if (Rnd.nextInt(100) < StormPct)
+            {
+                Stress_Storm(*Proc, Rnd, 1 + Rnd.nextInt(20));
+                Storms++;
+            }
+            if (Rnd.nextInt(200) == 0)
+            {
+                Bypassed = !Bypassed;
+                Bypasses++;
+            }
+
+            Midi.clear();
+            juce::int64 Start = juce::Time::getHighResolutionTicks();
+            if (Bypassed)
+                Proc->processBlockBypassed(Buf, Midi);
+            else
+                Proc->processBlock(Buf, Midi);
+            double Ns = double(juce::Time::getHighResolutionTicks() - Start) * TickNs;
+
+            //R1.01 Any NaN, infinity or wild value is a failure.
+            for (int ch = 0; ch < Chans; ch++)
+            {
+                const float* d = Buf.getReadPointer(ch);
+                for (int t = 0; t < num; t++)
+                    if (!std::isfinite(d[t]) || (64.0f < fabsf(d[t]))) BadSamples++;
+            }
+
+            t_StressTiming& T = Timing[Stress_Class(num)];
+            T.NsPerSample.push_back(Ns / num);
+            double Budget = Ns / (1.0e9 * num / Rate);
+            if (T.WorstBudget < Budget)
+            {
+                T.WorstBudget = Budget;
+                T.WorstSize = num;
+                T.WorstRate = Rate;
+            }
+
+            Blocks++;
+            Samples += num;
+            Pos += num;
+        }
+
+        //R1.01 Sometimes release, sometimes go straight to the next prepareToPlay.
+        if (Rnd.nextBool()) Proc->releaseResources();
+    }
+
+    //R1.01 REPORT.
+    std::cout << std::endl << Blocks << " blocks, " << Samples << " samples, " << Storms << " parameter storms, "
+              << Bypasses << " bypass flips." << std::endl;
+    std::cout << "Cost per sample (ns)   median      p99      max   jitter(p99/median)   worst block (% of real time)" << std::endl;
+    for (int c = 0; c < STRESS_Classes; c++)
+    {
+        t_StressTiming& T = Timing[c];
+        if (T.NsPerSample.empty()) continue;
+        double Max = *std::max_element(T.NsPerSample.begin(), T.NsPerSample.end());
+        double P99 = Stress_Percentile(T.NsPerSample, .99);
+        double Med = Stress_Percentile(T.NsPerSample, .5);
+        std::cout << "  block " << STRESS_ClassNames[c] << ":  " << Med << "  " << P99 << "  " << Max << "  "
+                  << ((0.0 < Med) ? P99 / Med : 0.0) << "x   " << (100.0 * T.WorstBudget) << "% (" << T.WorstSize
+                  << " samples at " << T.WorstRate << " Hz)" << std::endl;
+    }
+
+    bool Failed = (0 < BadSamples);
+    if (BadSamples) std::cout << "FAILED: " << BadSamples << " output samples were NaN, infinite or out of range." << std::endl;
+
+   #if MAKO_CLAP
+    if (0 < Stress_Direct(*Proc)) Failed = true;
+    else std::cout << "CLAP direct events still in effect after the next block." << std::endl;
+   #endif
+
+   #if MAKO_BOUNDS_CHECK
+    int Cnt = MakoBounds::Count();
+    if (0 < Cnt)
+    {
+        Failed = true;
+        MakoBounds::t_Violation List[32];
+        int n = MakoBounds::Get(List, 32);
+        std::cout << "FAILED: " << Cnt << " out of range buffer accesses." << std::endl;
+        for (int t = 0; t < n; t++)
+            std::cout << "  " << List[t].What << ": " << List[t].Count << " from " << List[t].Start << " in " << List[t].Size << std::endl;
+    }
+    else
+    {
+        std::cout << "No out of range buffer access." << std::endl;
+    }
+   #endif
+
+    return Failed ? 1 : 0;
+}